@@ -234,14 +234,18 @@ namespace NSE.DebuggerFrontend
             return Send(msg);
         }
 
-        public UInt32 SendGetVariables(BackendVariableReference vref)
+        public UInt32 SendGetVariables(BackendVariableReference vref, DbgGetVariables.Types.Filter filter = DbgGetVariables.Types.Filter.All,
+            UInt32 start = 0, UInt32 count = 0)
         {
             var eval = new DbgGetVariables
             {
                 Context = vref.Context,
                 VariableRef = vref.VariableRef,
                 Frame = vref.Frame,
-                Local = vref.Local
+                Local = vref.Local,
+                Start = start,
+                Count = count,
+                Filter = filter
             };
 
             if (vref.Keys != null)
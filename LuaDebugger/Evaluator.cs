@@ -156,15 +156,17 @@ namespace NSE.DebuggerFrontend
             }
         }
 
-        private void OnVariablesReceived(DAPRequest request, DAPVariablesRequest msg, ThreadState state, BkGetVariablesResponse response)
+        private void OnVariablesReceived(DAPRequest request, DAPVariablesRequest msg, ThreadState state, BkGetVariablesResponse response,
+            bool pagedByBackend)
         {
-            int startIndex = msg.start == null ? 0 : (int)msg.start;
-            int numVars = (msg.count == null || msg.count == 0) ? response.Result.Count : (int)msg.count;
+            // Backend variable requests are already limited to the requested range
+            int startIndex = (pagedByBackend || msg.start == null) ? 0 : (int)msg.start;
+            int numVars = (pagedByBackend || msg.count == null || msg.count == 0) ? response.Result.Count : (int)msg.count;
             int lastIndex = Math.Min(startIndex + numVars, response.Result.Count);
-            // TODO req.filter, format
+            // TODO format
 
             var variables = new List<DAPVariable>();
-            for (var i = startIndex; i < startIndex + numVars; i++)
+            for (var i = startIndex; i < lastIndex; i++)
             {
                 var variable = response.Result[i];
                 var dapVar = new DAPVariable
@@ -189,11 +191,24 @@ namespace NSE.DebuggerFrontend
                     var varsIdx = NextVariableReference++;
                     VariableRefs.Add(varsIdx, varsRef);
                     dapVar.variablesReference = MakeVariableRef(varsIdx);
+                    if (variable.Value.Variables.IndexedCount > 0)
+                    {
+                        dapVar.indexedVariables = variable.Value.Variables.IndexedCount;
+                    }
                 }
 
                 variables.Add(dapVar);
             }
 
+            if (response.HasMore)
+            {
+                variables.Add(new DAPVariable
+                {
+                    name = "...",
+                    value = "(more entries not shown)"
+                });
+            }
+
             var reply = new DAPVariablesResponse
             {
                 variables = variables
@@ -230,7 +245,7 @@ namespace NSE.DebuggerFrontend
                     response.Result.Clear();
                     response.Result.AddRange(results);
 
-                    OnVariablesReceived(request, msg, state, response);
+                    OnVariablesReceived(request, msg, state, response, false);
                 }
                 else if (status == StatusCode.EvalFailed && response != null)
                 {
@@ -257,12 +272,24 @@ namespace NSE.DebuggerFrontend
                 throw new RequestFailedException("Cannot fetch variables when thread is not stopped");
             }
 
-            uint seq = DAP.DbgCli.SendGetVariables(varRef);
+            var filter = DbgGetVariables.Types.Filter.All;
+            if (msg.filter == "indexed")
+            {
+                filter = DbgGetVariables.Types.Filter.Indexed;
+            }
+            else if (msg.filter == "named")
+            {
+                filter = DbgGetVariables.Types.Filter.Named;
+            }
+
+            uint start = msg.start == null ? 0 : (uint)msg.start;
+            uint count = msg.count == null ? 0 : (uint)msg.count;
+            uint seq = DAP.DbgCli.SendGetVariables(varRef, filter, start, count);
             PendingGetVariablesRequests.Add(seq, (uint replySeq, StatusCode status, BkGetVariablesResponse response) =>
             {
                 if (status == StatusCode.Success)
                 {
-                    OnVariablesReceived(request, msg, state, response);
+                    OnVariablesReceived(request, msg, state, response, true);
                 }
                 else if (status == StatusCode.EvalFailed && response != null)
                 {
@@ -321,6 +348,10 @@ namespace NSE.DebuggerFrontend
                     var varsIdx = NextVariableReference++;
                     VariableRefs.Add(varsIdx, varsRef);
                     evalResponse.variablesReference = MakeVariableRef(varsIdx);
+                    if (response.Result.Variables.IndexedCount > 0)
+                    {
+                        evalResponse.indexedVariables = response.Result.Variables.IndexedCount;
+                    }
                 }
             }
 
@@ -0,0 +1,450 @@
+#include "MappingsCompiler.h"
+#include <Extender/Shared/tinyxml2.h>
+#include <iostream>
+#include <cstring>
+#include <cctype>
+
+using namespace dse;
+
+std::optional<uint8_t> HexByteToByte(char c1, char c2)
+{
+	auto hexChar = [](char c) -> int {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'A' && c <= 'F') return c - 'A' + 0x0A;
+		if (c >= 'a' && c <= 'f') return c - 'a' + 0x0A;
+		return -1;
+	};
+
+	auto hi = hexChar(c1), lo = hexChar(c2);
+	if (hi == -1 || lo == -1) {
+		std::cout << "Invalid hexadecimal byte: " << c1 << c2 << std::endl;
+		return {};
+	}
+
+	return (uint8_t)((hi << 4) | lo);
+}
+
+std::optional<int> ParseInt(char const* name, char const* value)
+{
+	std::size_t readSize{ 0 };
+	int parsed;
+	try {
+		parsed = std::stoi(value, &readSize, 0);
+	} catch (std::exception const& e) {
+		std::cout << "Invalid int value in XML attribute '" << name << "': '" << value << "' (" << e.what() << ")" << std::endl;
+		return {};
+	}
+
+	if (readSize != strlen(value)) {
+		std::cout << "Invalid int value in XML attribute '" << name << "': '" << value << "' (garbage found at end of string)" << std::endl;
+		return {};
+	}
+
+	return parsed;
+}
+
+std::string GetElementText(tinyxml2::XMLElement* ele)
+{
+	std::string text;
+	auto node = ele->FirstChild();
+	while (node) {
+		auto textNode = node->ToText();
+		if (textNode) {
+			text += textNode->Value();
+		}
+
+		node = node->NextSibling();
+	}
+
+	return text;
+}
+
+uint32_t MappingsCompiler::AddString(char const* s)
+{
+	if (s == nullptr) {
+		return binmap::NoString;
+	}
+
+	auto it = stringOffsets_.find(s);
+	if (it != stringOffsets_.end()) {
+		return it->second;
+	}
+
+	auto offset = (uint32_t)strings_.size();
+	strings_.insert(strings_.end(), s, s + strlen(s) + 1);
+	stringOffsets_.insert(std::make_pair(std::string(s), offset));
+	return offset;
+}
+
+bool MappingsCompiler::CompilePattern(std::string_view s, std::unordered_map<std::string, uint32_t>& anchors)
+{
+	// Keep in sync with Pattern::FromString()
+	auto patternStart = (uint32_t)patternBytes_.size();
+	char const* c = s.data();
+	while (*c) {
+		if (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+			c++;
+			continue;
+		}
+
+		if (*c == '/') {
+			while (*c && *c != '\r' && *c != '\n') c++;
+			continue;
+		}
+
+		if (*c == '@') {
+			c++;
+			auto anchorStart = c;
+			while (*c && std::isalnum(*c)) c++;
+			if (c != anchorStart) {
+				anchors.insert(std::make_pair(std::string(anchorStart, c - anchorStart), (uint32_t)patternBytes_.size() - patternStart));
+				c++;
+			} else {
+				std::cout << "Empty anchor name found" << std::endl;
+				return false;
+			}
+
+			continue;
+		}
+
+		binmap::PatternByte b;
+		if (!c[1] || !c[2] || !std::isspace(c[2])) {
+			std::cout << "Bytes must be separated by whitespace" << std::endl;
+			return false;
+		}
+
+		if (c[0] == '?' && c[1] == '?') {
+			b.pattern = 0;
+			b.mask = 0;
+		} else {
+			auto patByte = HexByteToByte(c[0], c[1]);
+			if (!patByte) {
+				return false;
+			}
+
+			b.pattern = *patByte;
+			b.mask = 0xff;
+		}
+
+		patternBytes_.push_back(b);
+		c += 3;
+	}
+
+	if (patternBytes_.size() == patternStart) {
+		std::cout << "Zero-length patterns not allowed" << std::endl;
+		return false;
+	}
+
+	if (patternBytes_[patternStart].mask != 0xff) {
+		std::cout << "First byte of pattern must be an exact match" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool MappingsCompiler::CompilePatchBytes(std::string_view s)
+{
+	char const* c = s.data();
+	while (*c) {
+		if (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+			c++;
+			continue;
+		}
+
+		if (*c == '/') {
+			while (*c && *c != '\r' && *c != '\n') c++;
+			continue;
+		}
+
+		if (!c[1] || !c[2] || !std::isspace(c[2])) {
+			std::cout << "Bytes must be separated by whitespace" << std::endl;
+			return false;
+		}
+
+		auto patByte = HexByteToByte(c[0], c[1]);
+		if (!patByte) {
+			return false;
+		}
+
+		patchBytes_.push_back(*patByte);
+		c += 3;
+	}
+
+	return true;
+}
+
+std::optional<int> MappingsCompiler::GetOffsetAttribute(tinyxml2::XMLElement* ele, std::unordered_map<std::string, uint32_t> const& anchors,
+	char const* name)
+{
+	auto value = ele->Attribute(name);
+	if (value == nullptr) {
+		return {};
+	}
+
+	if (*value == '@') {
+		auto anchor = anchors.find(value + 1);
+		if (anchor == anchors.end()) {
+			std::cout << "Invalid anchor reference in XML attribute '" << name << "': '" << value << "'" << std::endl;
+			return {};
+		}
+
+		return (int)anchor->second;
+	}
+
+	return ParseInt(name, value);
+}
+
+bool MappingsCompiler::CompileReference(tinyxml2::XMLElement* ele, std::unordered_map<std::string, uint32_t> const& anchors,
+	binmap::Reference& ref)
+{
+	auto type = ele->Attribute("Type");
+	if (!type) {
+		std::cout << "Mapping reference must have a Type property." << std::endl;
+		return false;
+	}
+
+	if (strcmp(type, "Absolute") == 0) {
+		ref.Type = binmap::ReferenceType::Absolute;
+	} else if (strcmp(type, "Indirect") == 0) {
+		ref.Type = binmap::ReferenceType::Indirect;
+	} else {
+		std::cout << "Unsupported mapping reference type: " << type << std::endl;
+		return false;
+	}
+
+	auto offset = GetOffsetAttribute(ele, anchors, "Offset");
+	if (!offset) {
+		std::cout << "Mapping reference has invalid Offset value." << std::endl;
+		return false;
+	}
+
+	ref.Offset = *offset;
+	return true;
+}
+
+bool MappingsCompiler::CompileMapping(tinyxml2::XMLElement* ele)
+{
+	binmap::Mapping sym{};
+
+	auto name = ele->Attribute("Name");
+	if (!name) {
+		std::cout << "Mapping must have a name" << std::endl;
+		return false;
+	}
+
+	sym.Name = AddString(name);
+
+	auto scope = ele->Attribute("Scope");
+	if (scope == nullptr || strcmp(scope, "Text") == 0) {
+		sym.Scope = binmap::MatchScope::Text;
+	} else if (strcmp(scope, "Binary") == 0) {
+		sym.Scope = binmap::MatchScope::Binary;
+	} else if (strcmp(scope, "Custom") == 0) {
+		sym.Scope = binmap::MatchScope::Custom;
+	} else {
+		std::cout << "Mapping '" << name << "' uses unsupported scope type: " << scope << std::endl;
+		return false;
+	}
+
+	if (sym.Scope != binmap::MatchScope::Custom) {
+		auto mod = ele->Attribute("Module");
+		sym.Module = AddString(mod ? mod : "Main");
+	} else {
+		sym.Module = binmap::NoString;
+	}
+
+	if (ele->BoolAttribute("Critical")) sym.Flags |= binmap::Critical;
+	if (ele->BoolAttribute("Deferred")) sym.Flags |= binmap::Deferred;
+	if (ele->BoolAttribute("AllowFail")) sym.Flags |= binmap::AllowFail;
+
+	std::unordered_map<std::string, uint32_t> anchors;
+	sym.Pattern.Offset = (uint32_t)patternBytes_.size();
+	if (!CompilePattern(GetElementText(ele), anchors)) {
+		std::cout << "Failed to parse pattern of mapping '" << name << "'" << std::endl;
+		return false;
+	}
+	sym.Pattern.Count = (uint32_t)patternBytes_.size() - sym.Pattern.Offset;
+
+	sym.Targets.Offset = (uint32_t)targets_.size();
+	for (auto targetNode = ele->FirstChildElement("Target"); targetNode != nullptr; targetNode = targetNode->NextSiblingElement("Target")) {
+		binmap::Target target{};
+		if (!CompileReference(targetNode, anchors, target.Ref)) {
+			std::cout << "Failed to parse target of mapping '" << name << "'" << std::endl;
+			return false;
+		}
+
+		auto staticSymbol = targetNode->Attribute("Symbol");
+		auto targetName = targetNode->Attribute("Name");
+		target.Name = AddString(targetName ? targetName : (staticSymbol ? staticSymbol : "(Unnamed)"));
+		target.Symbol = AddString(staticSymbol);
+		target.NextSymbol = AddString(targetNode->Attribute("NextSymbol"));
+		target.EngineCallback = AddString(targetNode->Attribute("EngineCallback"));
+
+		if (target.NextSymbol != binmap::NoString) {
+			auto seekSize = targetNode->Attribute("NextSymbolSeekSize");
+			auto parsed = seekSize ? ParseInt("NextSymbolSeekSize", seekSize) : std::optional<int>();
+			if (!parsed || *parsed <= 0) {
+				std::cout << "Target of mapping '" << name << "' has invalid NextSymbolSeekSize value." << std::endl;
+				return false;
+			}
+
+			target.NextSymbolSeekSize = *parsed;
+		}
+
+		if (target.NextSymbol == binmap::NoString && target.EngineCallback == binmap::NoString && target.Symbol == binmap::NoString) {
+			std::cout << "Target of mapping '" << name << "' doesn't specify any actions!" << std::endl;
+			return false;
+		}
+
+		targets_.push_back(target);
+	}
+	sym.Targets.Count = (uint32_t)targets_.size() - sym.Targets.Offset;
+
+	sym.Patches.Offset = (uint32_t)patches_.size();
+	for (auto patchNode = ele->FirstChildElement("Patch"); patchNode != nullptr; patchNode = patchNode->NextSiblingElement("Patch")) {
+		binmap::Patch patch{};
+		if (!CompileReference(patchNode, anchors, patch.Ref)) {
+			std::cout << "Failed to parse patch of mapping '" << name << "'" << std::endl;
+			return false;
+		}
+
+		patch.Bytes.Offset = (uint32_t)patchBytes_.size();
+		if (!CompilePatchBytes(GetElementText(patchNode))) {
+			std::cout << "Failed to parse patch replacement of mapping '" << name << "'" << std::endl;
+			return false;
+		}
+		patch.Bytes.Count = (uint32_t)patchBytes_.size() - patch.Bytes.Offset;
+
+		patches_.push_back(patch);
+	}
+	sym.Patches.Count = (uint32_t)patches_.size() - sym.Patches.Offset;
+
+	sym.Conditions.Offset = (uint32_t)conditions_.size();
+	for (auto conditionNode = ele->FirstChildElement("Condition"); conditionNode != nullptr; conditionNode = conditionNode->NextSiblingElement("Condition")) {
+		binmap::Condition condition{};
+		auto type = conditionNode->Attribute("Type");
+		if (type == nullptr) {
+			std::cout << "Condition of mapping '" << name << "' has no type" << std::endl;
+			return false;
+		} else if (strcmp(type, "String") == 0) {
+			condition.Type = binmap::MatchType::String;
+		} else if (strcmp(type, "WString") == 0) {
+			condition.Type = binmap::MatchType::WString;
+		} else if (strcmp(type, "FixedString") == 0) {
+			condition.Type = binmap::MatchType::FixedString;
+		} else if (strcmp(type, "FixedStringIndirect") == 0) {
+			condition.Type = binmap::MatchType::FixedStringIndirect;
+		} else {
+			std::cout << "Unsupported mapping condition type: " << type << std::endl;
+			return false;
+		}
+
+		auto offset = GetOffsetAttribute(conditionNode, anchors, "Offset");
+		if (!offset) {
+			std::cout << "Condition of mapping '" << name << "' has invalid Offset value." << std::endl;
+			return false;
+		}
+		condition.Offset = *offset;
+
+		auto value = conditionNode->Attribute("Value");
+		if (!value) {
+			std::cout << "String value missing from condition of mapping '" << name << "'" << std::endl;
+			return false;
+		}
+		condition.Value = AddString(value);
+
+		if (condition.Type == binmap::MatchType::FixedString
+			|| condition.Type == binmap::MatchType::FixedStringIndirect) {
+			sym.Flags |= binmap::Deferred;
+		}
+
+		conditions_.push_back(condition);
+	}
+	sym.Conditions.Count = (uint32_t)conditions_.size() - sym.Conditions.Offset;
+
+	mappings_.push_back(sym);
+	return true;
+}
+
+bool MappingsCompiler::CompileDllImport(tinyxml2::XMLElement* ele)
+{
+	binmap::DllImport imp{};
+	auto symbol = ele->Attribute("Symbol");
+	auto mod = ele->Attribute("Module");
+	auto proc = ele->Attribute("Proc");
+	if (!symbol || !mod || !proc) {
+		std::cout << "DllImport must have a symbol, module and proc name" << std::endl;
+		return false;
+	}
+
+	imp.Symbol = AddString(symbol);
+	imp.Module = AddString(mod);
+	imp.Proc = AddString(proc);
+	dllImports_.push_back(imp);
+	return true;
+}
+
+bool MappingsCompiler::Compile(std::string const& xmlPath)
+{
+	tinyxml2::XMLDocument doc;
+	if (doc.LoadFile(xmlPath.c_str()) != tinyxml2::XML_SUCCESS) {
+		std::cout << "Couldn't parse binary mappings XML: " << xmlPath << std::endl;
+		return false;
+	}
+
+	auto mappingsNode = doc.RootElement()->FirstChildElement("Mappings");
+	while (mappingsNode != nullptr && !mappingsNode->BoolAttribute("Default")) {
+		mappingsNode = mappingsNode->NextSiblingElement("Mappings");
+	}
+
+	if (mappingsNode == nullptr) {
+		std::cout << "No default <Mappings> node found" << std::endl;
+		return false;
+	}
+
+	for (auto ele = mappingsNode->FirstChildElement(); ele != nullptr; ele = ele->NextSiblingElement()) {
+		if (strcmp(ele->Name(), "Mapping") == 0) {
+			if (!CompileMapping(ele)) return false;
+		} else if (strcmp(ele->Name(), "DllImport") == 0) {
+			if (!CompileDllImport(ele)) return false;
+		} else {
+			std::cout << "Unknown element in <Mappings>: " << ele->Name() << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <class T>
+binmap::Range AppendSection(std::vector<uint8_t>& blob, std::vector<T> const& items)
+{
+	// Keep each section 8-byte aligned so the runtime can read records in-place
+	blob.resize((blob.size() + 7) & ~(std::size_t)7);
+	binmap::Range range{ (uint32_t)blob.size(), (uint32_t)items.size() };
+	auto bytes = reinterpret_cast<uint8_t const*>(items.data());
+	blob.insert(blob.end(), bytes, bytes + items.size() * sizeof(T));
+	return range;
+}
+
+std::vector<uint8_t> MappingsCompiler::Pack() const
+{
+	std::vector<uint8_t> blob;
+	blob.resize(sizeof(binmap::Header));
+
+	binmap::Header header{};
+	header.Magic = binmap::Magic;
+	header.Version = binmap::Version;
+	header.Strings = AppendSection(blob, strings_);
+	header.PatternBytes = AppendSection(blob, patternBytes_);
+	header.PatchBytes = AppendSection(blob, patchBytes_);
+	header.Mappings = AppendSection(blob, mappings_);
+	header.Conditions = AppendSection(blob, conditions_);
+	header.Targets = AppendSection(blob, targets_);
+	header.Patches = AppendSection(blob, patches_);
+	header.DllImports = AppendSection(blob, dllImports_);
+
+	memcpy(blob.data(), &header, sizeof(header));
+	return blob;
+}
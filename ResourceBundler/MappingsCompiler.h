@@ -0,0 +1,41 @@
+#pragma once
+
+#include <GameHooks/BinaryMappingsFormat.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tinyxml2 {
+	class XMLElement;
+}
+
+// Compiles BinaryMappings*.xml to the precompiled format described in BinaryMappingsFormat.h
+class MappingsCompiler
+{
+public:
+	bool Compile(std::string const& xmlPath);
+	std::vector<uint8_t> Pack() const;
+
+private:
+	std::vector<char> strings_;
+	std::unordered_map<std::string, uint32_t> stringOffsets_;
+	std::vector<dse::binmap::PatternByte> patternBytes_;
+	std::vector<uint8_t> patchBytes_;
+	std::vector<dse::binmap::Mapping> mappings_;
+	std::vector<dse::binmap::Condition> conditions_;
+	std::vector<dse::binmap::Target> targets_;
+	std::vector<dse::binmap::Patch> patches_;
+	std::vector<dse::binmap::DllImport> dllImports_;
+
+	uint32_t AddString(char const* s);
+	bool CompileMapping(tinyxml2::XMLElement* ele);
+	bool CompileDllImport(tinyxml2::XMLElement* ele);
+	bool CompilePattern(std::string_view s, std::unordered_map<std::string, uint32_t>& anchors);
+	bool CompilePatchBytes(std::string_view s);
+	bool CompileReference(tinyxml2::XMLElement* ele, std::unordered_map<std::string, uint32_t> const& anchors,
+		dse::binmap::Reference& ref);
+	std::optional<int> GetOffsetAttribute(tinyxml2::XMLElement* ele, std::unordered_map<std::string, uint32_t> const& anchors,
+		char const* name);
+};
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <cstring>
+#include "MappingsCompiler.h"
 
 class LuaBundler
 {
@@ -70,8 +72,32 @@ private:
 	std::vector<ResourceInfo> paths_;
 };
 
+int CompileMappings(char const* xmlPath, char const* outPath)
+{
+	MappingsCompiler compiler;
+	if (!compiler.Compile(xmlPath)) {
+		std::cout << "Failed to compile binary mappings: " << xmlPath << std::endl;
+		return 1;
+	}
+
+	auto blob = compiler.Pack();
+	std::ofstream f(outPath, std::ios::out | std::ios::binary);
+	if (!f.good()) {
+		std::cout << "Couldn't open mappings file: " << outPath << std::endl;
+		return 1;
+	}
+
+	f.write((char *)blob.data(), blob.size());
+	f.close();
+	return 0;
+}
+
 int main(int argc, char const ** argv)
 {
+	if (argc == 4 && strcmp(argv[1], "--mappings") == 0) {
+		return CompileMappings(argv[2], argv[3]);
+	}
+
 	LuaBundler bundler;
 	bundler.AddResources(argv[1]);
 	auto pack = bundler.Pack();
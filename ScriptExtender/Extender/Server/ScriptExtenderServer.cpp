@@ -199,6 +199,8 @@ void ScriptExtender::OnUpdate(void* self, GameTime* time)
 	if (extensionState_) {
 		extensionState_->OnUpdate(*time);
 	}
+
+	osiris_.OnUpdate();
 }
 
 bool ScriptExtender::IsInServerThread() const
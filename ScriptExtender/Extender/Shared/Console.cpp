@@ -127,6 +127,8 @@ void DebugConsole::PrintHelp()
 	DEBUG("  reset server - Reset server Lua state");
 	DEBUG("  reset - Reset client and server Lua states");
 	DEBUG("  silence <on|off> - Enable/disable silent mode (log output when in input mode)");
+	DEBUG("  profile start [interval] - Start sampling profiler in the current context (interval in microseconds)");
+	DEBUG("  profile stop [file] - Stop sampling profiler and save folded stacks to the specified file");
 	DEBUG("  clear - Clear the console");
 	DEBUG("  exit - Leave console mode");
 	DEBUG("  !<cmd> <arg1> ... <argN> - Trigger Lua \"ConsoleCommand\" event with arguments cmd, arg1, ..., argN");
@@ -218,6 +220,51 @@ void DebugConsole::ExecLuaCommand(std::string const& cmd)
 	SubmitTaskAndWait(serverContext_, task);
 }
 
+void DebugConsole::ProfilerCommand(std::string const& cmd)
+{
+	auto task = [cmd, server = serverContext_]() {
+		auto state = gExtender->GetCurrentExtensionState();
+		if (!state) {
+			ERR("Extensions not initialized!");
+			return;
+		}
+
+		LuaVirtualPin pin(*state);
+		if (!pin) {
+			ERR("Lua state not initialized!");
+			return;
+		}
+
+		auto& profiler = pin->GetProfiler();
+		auto L = pin->GetState();
+		if (cmd.starts_with("start")) {
+			uint32_t interval = (cmd.size() > 6) ? (uint32_t)strtoul(cmd.c_str() + 6, nullptr, 10) : 0;
+			if (interval == 0) {
+				interval = lua::SamplingProfiler::DefaultIntervalUs;
+			}
+
+			profiler.Reset();
+			if (profiler.Start(L, interval)) {
+				DEBUG("Profiler started (sampling interval %d us).", interval);
+			}
+		} else if (cmd.starts_with("stop")) {
+			profiler.Stop(L);
+			std::string path = (cmd.size() > 5) ? cmd.substr(5) : (server ? "LuaProfile-Server.folded" : "LuaProfile-Client.folded");
+			DEBUG("Profiler stopped: %lld samples, %lld distinct stacks, %lld dropped samples.",
+				(int64_t)profiler.NumSamples(), (int64_t)profiler.NumStacks(), (int64_t)profiler.NumDroppedSamples());
+			if (profiler.SaveFoldedStacks(path)) {
+				DEBUG("Folded stacks saved to %s", path.c_str());
+			} else {
+				ERR("Failed to save folded stacks to %s", path.c_str());
+			}
+		} else {
+			ERR("Usage: profile <start|stop> [interval|file]");
+		}
+	};
+
+	SubmitTaskAndWait(serverContext_, task);
+}
+
 void DebugConsole::HandleCommand(std::string const& cmd)
 {
 	if (cmd.empty()) {
@@ -239,6 +286,8 @@ void DebugConsole::HandleCommand(std::string const& cmd)
 	} else if (cmd == "silence off") {
 		DEBUG("Silent mode OFF");
 		silence_ = false;
+	} else if (cmd.starts_with("profile ")) {
+		ProfilerCommand(cmd.substr(8));
 	} else if (cmd == "clear") {
 		Clear();
 	} else if (cmd == "help") {
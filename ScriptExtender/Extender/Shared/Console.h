@@ -39,6 +39,7 @@ private:
 	void ResetLuaClient();
 	void ResetLuaServer();
 	void ExecLuaCommand(std::string const& cmd);
+	void ProfilerCommand(std::string const& cmd);
 	void ClearFromReset();
 };
 
@@ -29,12 +29,6 @@ struct ExcludedSymbol
 // Wrapper frames are included in the stack trace for any server/client worker thread crash,
 // so we have to filter them to make sure that we don't receive a report for every (unrelated) game crash.
 static const ExcludedSymbol ExcludedSymbols[] = {
-	{&dse::NodeVMTWrapper::s_WrappedIsValid, 0x100},
-	{&dse::NodeVMTWrapper::s_WrappedPushDownTuple, 0x100},
-	{&dse::NodeVMTWrapper::s_WrappedPushDownTupleDelete, 0x100},
-	{&dse::NodeVMTWrapper::s_WrappedInsertTuple, 0x100},
-	{&dse::NodeVMTWrapper::s_WrappedDeleteTuple, 0x100},
-	{&dse::NodeVMTWrapper::s_WrappedCallQuery, 0x100},
 	{&dse::UIObjectFunctionCallCapture, 0x120},
 	{&dse::CustomFunctionInjector::StaticCallWrapper, 0x120},
 	{&dse::CustomFunctionInjector::StaticQueryWrapper, 0x120}
@@ -33,6 +33,7 @@ struct ExtenderConfig
 	bool ClearOnReset{ false };
 
 	bool OptimizeHashing{ true };
+	bool EnableSymbolCache{ true };
 #if defined(OSI_EXTENSION_BUILD)
 	bool DisableModValidation{ true };
 #if defined(_DEBUG)
@@ -56,6 +57,8 @@ struct ExtenderConfig
 	uint32_t DebuggerPort{ 9999 };
 	uint32_t LuaDebuggerPort{ 9998 };
 	uint32_t DebugFlags{ 0 };
+	uint32_t LuaGCBudget{ 500 };
+	bool LuaGCFullCollectOnLoad{ true };
 	std::wstring LogDirectory;
 	std::wstring LuaBuiltinResourceDirectory;
 };
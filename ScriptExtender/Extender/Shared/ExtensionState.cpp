@@ -14,7 +14,8 @@ namespace dse
 		"CustomStatsPane",
 		"FormulaOverrides",
 		"Preprocessor",
-		"DisableFolding"
+		"DisableFolding",
+		"NativeMathTypes"
 	};
 
 	char const* sContextNames[] = {
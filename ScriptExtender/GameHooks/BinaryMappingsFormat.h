@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+// Layout of the precompiled binary mappings blob.
+// The blob is produced from BinaryMappings*.xml by ResourceBundler at build time and is
+// read in-place by SymbolMappingLoader; all offsets are relative to the start of the blob.
+namespace dse::binmap
+{
+	static constexpr uint32_t Magic = 0x4D424553; // 'SEBM'
+	static constexpr uint32_t Version = 1;
+	static constexpr uint32_t NoString = 0xffffffffu;
+
+	// Values must match the SymbolMappings enumerations
+	enum class MatchScope : uint32_t
+	{
+		Binary = 0,
+		Text = 1,
+		Custom = 2
+	};
+
+	enum class ReferenceType : uint32_t
+	{
+		None = 0,
+		Absolute = 1,
+		Indirect = 2
+	};
+
+	enum class MatchType : uint32_t
+	{
+		None = 0,
+		String = 1,
+		WString = 2,
+		FixedString = 3,
+		FixedStringIndirect = 4
+	};
+
+	enum MappingFlags : uint32_t
+	{
+		Critical = 1 << 0,
+		Deferred = 1 << 1,
+		AllowFail = 1 << 2
+	};
+
+	struct PatternByte
+	{
+		uint8_t pattern;
+		uint8_t mask;
+	};
+
+	struct Range
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		// Null-terminated strings, referenced by their offset in the string table
+		Range Strings;
+		Range PatternBytes;
+		Range PatchBytes;
+		Range Mappings;
+		Range Conditions;
+		Range Targets;
+		Range Patches;
+		Range DllImports;
+	};
+
+	struct Reference
+	{
+		ReferenceType Type;
+		int32_t Offset;
+	};
+
+	struct Condition
+	{
+		MatchType Type;
+		int32_t Offset;
+		uint32_t Value;
+	};
+
+	struct Target
+	{
+		uint32_t Name;
+		Reference Ref;
+		uint32_t Symbol;
+		uint32_t NextSymbol;
+		int32_t NextSymbolSeekSize;
+		uint32_t EngineCallback;
+	};
+
+	struct Patch
+	{
+		Reference Ref;
+		// Index range in the patch byte table
+		Range Bytes;
+	};
+
+	struct Mapping
+	{
+		uint32_t Name;
+		uint32_t Module;
+		MatchScope Scope;
+		uint32_t Flags;
+		// Index ranges in the respective tables
+		Range Pattern;
+		Range Conditions;
+		Range Targets;
+		Range Patches;
+	};
+
+	struct DllImport
+	{
+		uint32_t Symbol;
+		uint32_t Module;
+		uint32_t Proc;
+	};
+}
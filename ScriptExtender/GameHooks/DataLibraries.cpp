@@ -48,6 +48,10 @@ namespace dse
 		}
 
 		RegisterLibraries(symbolMapper_);
+		if (gExtender->GetConfig().EnableSymbolCache) {
+			symbolMapper_.EnableCache(GetSymbolCachePath());
+		}
+
 		symbolMapper_.MapAllSymbols(false);
 
 		CriticalInitFailed = CriticalInitFailed || symbolMapper_.HasFailedCriticalMappings();
@@ -66,6 +70,22 @@ namespace dse
 		return !CriticalInitFailed;
 	}
 
+	std::wstring LibraryManager::GetSymbolCachePath()
+	{
+		std::wstring tempPath;
+		DWORD tempPathLen = GetTempPathW(0, NULL);
+		tempPath.resize(tempPathLen);
+		GetTempPathW(tempPathLen, tempPath.data());
+		tempPath.resize(tempPathLen - 1);
+
+#if defined(OSI_EOCAPP)
+		tempPath += L"\\OsiExtSymbolCache_EoCApp.bin";
+#else
+		tempPath += L"\\OsiExtSymbolCache_EoCPlugin.bin";
+#endif
+		return tempPath;
+	}
+
 #define SYM_OFF(name) mappings_.StaticSymbols.insert(std::make_pair(#name, SymbolMappings::StaticSymbol{ (int)offsetof(StaticSymbols, name) }))
 #define CHAR_GETTER_SYM_OFF(name) mappings_.StaticSymbols.insert(std::make_pair("CharacterStatGetters__" #name, SymbolMappings::StaticSymbol{ (int)offsetof(StaticSymbols, CharStatsGetters) + (int)offsetof(stats::CharacterStatsGetters, name) }))
 
@@ -59,6 +59,7 @@ private:
 	void PreRegisterLibraries(SymbolMappingLoader& loader);
 	void RegisterLibraries(SymbolMapper& mapper);
 	void RegisterSymbols();
+	std::wstring GetSymbolCachePath();
 	bool BindApp();
 #if defined(OSI_EOCAPP)
 	void FindServerGlobalsEoCApp();
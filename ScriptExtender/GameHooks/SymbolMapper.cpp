@@ -6,6 +6,7 @@
 #include <functional>
 #include <psapi.h>
 #include <DbgHelp.h>
+#include <fstream>
 #include <Extender/Shared/tinyxml2.h>
 #include "resource.h"
 
@@ -22,6 +23,24 @@ void** StaticSymbolRef::Get() const
 	}
 }
 
+static constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ull;
+static constexpr uint64_t FNVPrime = 0x100000001b3ull;
+
+// FNV-1a variant that consumes 8 bytes per round
+uint64_t HashBytes(uint8_t const* data, std::size_t size, uint64_t hash = FNVOffsetBasis)
+{
+	auto end = data + (size & ~(std::size_t)7);
+	for (auto p = data; p < end; p += 8) {
+		hash = (hash ^ *reinterpret_cast<uint64_t const*>(p)) * FNVPrime;
+	}
+
+	for (auto p = end; p < data + size; p++) {
+		hash = (hash ^ *p) * FNVPrime;
+	}
+
+	return hash;
+}
+
 std::optional<uint8_t> CharToByte(char c)
 {
 	if (c >= '0' && c <= '9') {
@@ -47,10 +66,25 @@ std::optional<uint8_t> HexByteToByte(char c1, char c2)
 	}
 }
 
+Pattern::Pattern(Pattern const& o)
+	: ownedPattern_(o.ownedPattern_),
+	pattern_(o.ownedPattern_.empty() ? o.pattern_ : std::span<PatternByte const>(ownedPattern_)),
+	anchors_(o.anchors_)
+{}
+
+Pattern& Pattern::operator = (Pattern const& o)
+{
+	ownedPattern_ = o.ownedPattern_;
+	pattern_ = o.ownedPattern_.empty() ? o.pattern_ : std::span<PatternByte const>(ownedPattern_);
+	anchors_ = o.anchors_;
+	return *this;
+}
+
 bool Pattern::FromString(std::string_view s)
 {
-	pattern_.clear();
-	pattern_.reserve(100);
+	pattern_ = {};
+	ownedPattern_.clear();
+	ownedPattern_.reserve(100);
 
 	char const * c = s.data();
 	while (*c) {
@@ -69,7 +103,7 @@ bool Pattern::FromString(std::string_view s)
 			auto anchorStart = c;
 			while (*c && std::isalnum(*c)) c++;
 			if (c != anchorStart) {
-				anchors_.insert(std::make_pair(std::string(anchorStart, c - anchorStart), (unsigned)pattern_.size()));
+				anchors_.insert(std::make_pair(std::string(anchorStart, c - anchorStart), (unsigned)ownedPattern_.size()));
 				c++;
 			} else {
 				ERR("Empty anchor name found");
@@ -98,31 +132,40 @@ bool Pattern::FromString(std::string_view s)
 			b.mask = 0xff;
 		}
 
-		pattern_.push_back(b);
+		ownedPattern_.push_back(b);
 		c += 3;
 	}
 
-	if (pattern_.empty()) {
+	if (ownedPattern_.empty()) {
 		ERR("Zero-length patterns not allowed");
 		return false;
 	}
 
-	if (pattern_[0].mask != 0xff) {
+	if (ownedPattern_[0].mask != 0xff) {
 		ERR("First byte of pattern must be an exact match");
 		return false;
 	}
 
+	pattern_ = ownedPattern_;
 	return true;
 }
 
 void Pattern::FromRaw(const char * s)
 {
 	auto len = strlen(s) + 1;
-	pattern_.resize(len);
+	ownedPattern_.resize(len);
 	for (auto i = 0; i < len; i++) {
-		pattern_[i].pattern = (uint8_t)s[i];
-		pattern_[i].mask = 0xFF;
+		ownedPattern_[i].pattern = (uint8_t)s[i];
+		ownedPattern_[i].mask = 0xFF;
 	}
+	pattern_ = ownedPattern_;
+}
+
+void Pattern::FromCompiled(std::span<PatternByte const> bytes)
+{
+	ownedPattern_.clear();
+	anchors_.clear();
+	pattern_ = bytes;
 }
 
 bool Pattern::MatchPattern(uint8_t const * start) const
@@ -215,6 +258,239 @@ std::optional<uint32_t> Pattern::GetAnchor(char const* anchor) const
 	}
 }
 
+uint32_t MultiPatternScanner::AddNode()
+{
+	auto index = (uint32_t)nodes_.size();
+	nodes_.push_back(Node{});
+	transitions_.resize(transitions_.size() + 256, NoTransition);
+	return index;
+}
+
+void MultiPatternScanner::Add(Pattern const& pattern, uint32_t id)
+{
+	auto const& bytes = pattern.pattern_;
+
+	// Find the longest exact byte run; the first byte is always exact, so there is at least one
+	uint32_t bestOffset{ 0 }, bestLength{ 0 };
+	uint32_t runOffset{ 0 }, runLength{ 0 };
+	for (uint32_t i = 0; i < bytes.size(); i++) {
+		if (bytes[i].mask == 0xff) {
+			if (runLength == 0) runOffset = i;
+			runLength++;
+			if (runLength > bestLength) {
+				bestOffset = runOffset;
+				bestLength = runLength;
+			}
+		} else {
+			runLength = 0;
+		}
+	}
+
+	entries_.push_back(Entry{ &pattern, id, bestOffset, std::min(bestLength, MaxKeyLength) });
+}
+
+void MultiPatternScanner::Build()
+{
+	nodes_.clear();
+	transitions_.clear();
+	AddNode();
+
+	for (uint32_t i = 0; i < entries_.size(); i++) {
+		auto const& entry = entries_[i];
+		uint32_t node{ 0 };
+		for (uint32_t j = 0; j < entry.KeyLength; j++) {
+			auto ch = entry.Pat->pattern_[entry.KeyOffset + j].pattern;
+			auto next = transitions_[node * 256 + ch];
+			if (next == NoTransition) {
+				next = AddNode();
+				transitions_[node * 256 + ch] = next;
+			}
+			node = next;
+		}
+
+		nodes_[node].Outputs.push_back(i);
+	}
+
+	// Compute failure links in BFS order and turn the trie into a complete DFA
+	std::vector<uint32_t> queue;
+	queue.reserve(nodes_.size());
+	for (uint32_t ch = 0; ch < 256; ch++) {
+		auto& next = transitions_[ch];
+		if (next == NoTransition) {
+			next = 0;
+		} else {
+			nodes_[next].Fail = 0;
+			queue.push_back(next);
+		}
+	}
+
+	for (std::size_t i = 0; i < queue.size(); i++) {
+		auto node = queue[i];
+		auto fail = nodes_[node].Fail;
+		for (uint32_t ch = 0; ch < 256; ch++) {
+			auto& next = transitions_[node * 256 + ch];
+			if (next == NoTransition) {
+				next = transitions_[fail * 256 + ch];
+			} else {
+				auto nextFail = transitions_[fail * 256 + ch];
+				nodes_[next].Fail = nextFail;
+				auto const& inherited = nodes_[nextFail].Outputs;
+				nodes_[next].Outputs.insert(nodes_[next].Outputs.end(), inherited.begin(), inherited.end());
+				queue.push_back(next);
+			}
+		}
+	}
+}
+
+void MultiPatternScanner::Scan(uint8_t const* start, size_t length, std::function<void (uint32_t, uint8_t const*)> const& callback) const
+{
+	auto trans = transitions_.data();
+	uint32_t state{ 0 };
+	for (std::size_t pos = 0; pos < length; pos++) {
+		state = trans[state * 256 + start[pos]];
+		auto const& outputs = nodes_[state].Outputs;
+		if (outputs.empty()) continue;
+
+		for (auto entryIndex : outputs) {
+			auto const& entry = entries_[entryIndex];
+			auto keyEnd = pos + 1;
+			if (keyEnd < entry.KeyOffset + entry.KeyLength) continue;
+
+			// Same bounds as Pattern::Scan(): match start must be below (start + length - pattern size)
+			auto matchOffset = keyEnd - entry.KeyOffset - entry.KeyLength;
+			if (matchOffset + entry.Pat->pattern_.size() >= length) continue;
+
+			if (entry.Pat->MatchPattern(start + matchOffset)) {
+				callback(entry.Id, start + matchOffset);
+			}
+		}
+	}
+}
+
+template <class T>
+bool ReadCacheValue(std::ifstream& f, T& value)
+{
+	f.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return f.good();
+}
+
+template <class T>
+void WriteCacheValue(std::ofstream& f, T const& value)
+{
+	f.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+bool SymbolMappingCache::Load(std::wstring const& path, uint64_t key)
+{
+	key_ = key;
+	entries_.clear();
+	dirty_ = false;
+
+	std::ifstream f(path.c_str(), std::ios::in | std::ios::binary);
+	if (!f.good()) {
+		return false;
+	}
+
+	uint32_t magic, version, numEntries;
+	uint64_t fileKey;
+	if (!ReadCacheValue(f, magic) || !ReadCacheValue(f, version) || !ReadCacheValue(f, fileKey)
+		|| !ReadCacheValue(f, numEntries)) {
+		ERR("Symbol cache file is truncated");
+		return false;
+	}
+
+	if (magic != Magic || version != Version || fileKey != key) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < numEntries; i++) {
+		uint32_t nameLength, numOffsets;
+		if (!ReadCacheValue(f, nameLength) || nameLength > 0x1000) {
+			ERR("Symbol cache file is corrupted");
+			entries_.clear();
+			return false;
+		}
+
+		std::string name;
+		name.resize(nameLength);
+		f.read(name.data(), nameLength);
+
+		if (!ReadCacheValue(f, numOffsets) || numOffsets > 0x10000) {
+			ERR("Symbol cache file is corrupted");
+			entries_.clear();
+			return false;
+		}
+
+		std::vector<uint32_t> offsets;
+		offsets.resize(numOffsets);
+		f.read(reinterpret_cast<char*>(offsets.data()), numOffsets * sizeof(uint32_t));
+		if (!f.good()) {
+			ERR("Symbol cache file is truncated");
+			entries_.clear();
+			return false;
+		}
+
+		entries_.insert(std::make_pair(std::move(name), std::move(offsets)));
+	}
+
+	return true;
+}
+
+bool SymbolMappingCache::Save(std::wstring const& path)
+{
+	std::ofstream f(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!f.good()) {
+		ERR("Couldn't open symbol cache file for writing");
+		return false;
+	}
+
+	WriteCacheValue(f, Magic);
+	WriteCacheValue(f, Version);
+	WriteCacheValue(f, key_);
+	WriteCacheValue(f, (uint32_t)entries_.size());
+
+	for (auto const& entry : entries_) {
+		WriteCacheValue(f, (uint32_t)entry.first.size());
+		f.write(entry.first.data(), entry.first.size());
+		WriteCacheValue(f, (uint32_t)entry.second.size());
+		f.write(reinterpret_cast<char const*>(entry.second.data()), entry.second.size() * sizeof(uint32_t));
+	}
+
+	dirty_ = false;
+	return f.good();
+}
+
+std::vector<uint32_t> const* SymbolMappingCache::Get(std::string const& mapping) const
+{
+	auto it = entries_.find(mapping);
+	if (it != entries_.end()) {
+		return &it->second;
+	} else {
+		return nullptr;
+	}
+}
+
+void SymbolMappingCache::Set(std::string const& mapping, std::vector<uint32_t>&& offsets)
+{
+	auto it = entries_.find(mapping);
+	if (it != entries_.end()) {
+		if (it->second != offsets) {
+			it->second = std::move(offsets);
+			dirty_ = true;
+		}
+	} else {
+		entries_.insert(std::make_pair(mapping, std::move(offsets)));
+		dirty_ = true;
+	}
+}
+
+void SymbolMappingCache::Remove(std::string const& mapping)
+{
+	if (entries_.erase(mapping) > 0) {
+		dirty_ = true;
+	}
+}
+
 std::optional<int> GetIntAttribute(tinyxml2::XMLElement* ele, char const* name)
 {
 	char const* value{ nullptr };
@@ -280,6 +556,18 @@ void SymbolMappingLoader::AddKnownModule(std::string const& name)
 
 bool SymbolMappingLoader::LoadBuiltinMappings()
 {
+	// Development builds always parse the XML so that mapping changes don't require a ResourceBundler run
+#if !defined(_DEBUG)
+	auto compiled = GetExeResourceView(IDR_BINARY_MAPPINGS_COMPILED);
+	if (compiled) {
+		if (LoadCompiledMappings(*compiled)) {
+			return true;
+		}
+
+		ERR("Couldn't load compiled binary mappings; falling back to XML mappings");
+	}
+#endif
+
 #if defined(OSI_EOCAPP)
 	auto xml = GetExeResource(IDR_BINARY_MAPPINGS_EOCAPP);
 #else
@@ -291,6 +579,8 @@ bool SymbolMappingLoader::LoadBuiltinMappings()
 		return false;
 	}
 
+	mappings_.SourceHash = HashBytes(reinterpret_cast<uint8_t const*>(xml->data()), xml->size());
+
 	tinyxml2::XMLDocument doc;
 	auto err = doc.Parse(xml->c_str(), xml->size());
 	if (err != tinyxml2::XML_SUCCESS) {
@@ -672,6 +962,266 @@ bool SymbolMappingLoader::LoadCondition(tinyxml2::XMLElement* ele, Pattern const
 }
 
 
+static_assert((uint32_t)SymbolMappings::MatchScope::kBinary == (uint32_t)binmap::MatchScope::Binary
+	&& (uint32_t)SymbolMappings::MatchScope::kText == (uint32_t)binmap::MatchScope::Text
+	&& (uint32_t)SymbolMappings::MatchScope::kCustom == (uint32_t)binmap::MatchScope::Custom);
+static_assert((uint32_t)SymbolMappings::ReferenceType::kAbsolute == (uint32_t)binmap::ReferenceType::Absolute
+	&& (uint32_t)SymbolMappings::ReferenceType::kIndirect == (uint32_t)binmap::ReferenceType::Indirect);
+static_assert((uint32_t)SymbolMappings::MatchType::kString == (uint32_t)binmap::MatchType::String
+	&& (uint32_t)SymbolMappings::MatchType::kWString == (uint32_t)binmap::MatchType::WString
+	&& (uint32_t)SymbolMappings::MatchType::kFixedString == (uint32_t)binmap::MatchType::FixedString
+	&& (uint32_t)SymbolMappings::MatchType::kFixedStringIndirect == (uint32_t)binmap::MatchType::FixedStringIndirect);
+static_assert((uint32_t)SymbolMappings::Mapping::kCritical == (uint32_t)binmap::Critical
+	&& (uint32_t)SymbolMappings::Mapping::kDeferred == (uint32_t)binmap::Deferred
+	&& (uint32_t)SymbolMappings::Mapping::kAllowFail == (uint32_t)binmap::AllowFail);
+
+struct SymbolMappingLoader::CompiledMappings
+{
+	std::span<char const> Strings;
+	std::span<binmap::PatternByte const> PatternBytes;
+	std::span<uint8_t const> PatchBytes;
+	std::span<binmap::Mapping const> Mappings;
+	std::span<binmap::Condition const> Conditions;
+	std::span<binmap::Target const> Targets;
+	std::span<binmap::Patch const> Patches;
+	std::span<binmap::DllImport const> DllImports;
+
+	inline char const* GetString(uint32_t offset) const
+	{
+		return (offset == binmap::NoString) ? nullptr : Strings.data() + offset;
+	}
+
+	inline bool IsValidString(uint32_t offset) const
+	{
+		return offset == binmap::NoString || offset < Strings.size();
+	}
+
+	template <class T>
+	inline bool IsValidRange(binmap::Range const& range, std::span<T const> items) const
+	{
+		return range.Offset <= items.size() && items.size() - range.Offset >= range.Count;
+	}
+};
+
+template <class T>
+bool GetCompiledSection(std::string_view blob, binmap::Range const& range, std::span<T const>& items)
+{
+	if (range.Offset % alignof(T) != 0
+		|| range.Offset > blob.size()
+		|| (blob.size() - range.Offset) / sizeof(T) < range.Count) {
+		return false;
+	}
+
+	items = std::span<T const>(reinterpret_cast<T const*>(blob.data() + range.Offset), range.Count);
+	return true;
+}
+
+bool SymbolMappingLoader::LoadCompiledMappings(std::string_view blob)
+{
+	if (blob.size() < sizeof(binmap::Header)) {
+		ERR("Compiled binary mappings are truncated");
+		return false;
+	}
+
+	auto header = reinterpret_cast<binmap::Header const*>(blob.data());
+	if (header->Magic != binmap::Magic || header->Version != binmap::Version) {
+		ERR("Compiled binary mappings version mismatch");
+		return false;
+	}
+
+	CompiledMappings bin;
+	if (!GetCompiledSection(blob, header->Strings, bin.Strings)
+		|| !GetCompiledSection(blob, header->PatternBytes, bin.PatternBytes)
+		|| !GetCompiledSection(blob, header->PatchBytes, bin.PatchBytes)
+		|| !GetCompiledSection(blob, header->Mappings, bin.Mappings)
+		|| !GetCompiledSection(blob, header->Conditions, bin.Conditions)
+		|| !GetCompiledSection(blob, header->Targets, bin.Targets)
+		|| !GetCompiledSection(blob, header->Patches, bin.Patches)
+		|| !GetCompiledSection(blob, header->DllImports, bin.DllImports)
+		|| (!bin.Strings.empty() && bin.Strings.back() != 0)) {
+		ERR("Compiled binary mappings are corrupted");
+		return false;
+	}
+
+	// Validate all references before loading anything, so we can still fall back to XML mappings
+	for (auto const& mapping : bin.Mappings) {
+		if (!bin.IsValidString(mapping.Name) || !bin.IsValidString(mapping.Module)
+			|| !bin.IsValidRange(mapping.Pattern, bin.PatternBytes)
+			|| !bin.IsValidRange(mapping.Conditions, bin.Conditions)
+			|| !bin.IsValidRange(mapping.Targets, bin.Targets)
+			|| !bin.IsValidRange(mapping.Patches, bin.Patches)) {
+			ERR("Compiled binary mappings are corrupted");
+			return false;
+		}
+	}
+
+	for (auto const& condition : bin.Conditions) {
+		if (!bin.IsValidString(condition.Value)) {
+			ERR("Compiled binary mappings are corrupted");
+			return false;
+		}
+	}
+
+	for (auto const& target : bin.Targets) {
+		if (!bin.IsValidString(target.Name) || !bin.IsValidString(target.Symbol)
+			|| !bin.IsValidString(target.NextSymbol) || !bin.IsValidString(target.EngineCallback)) {
+			ERR("Compiled binary mappings are corrupted");
+			return false;
+		}
+	}
+
+	for (auto const& patch : bin.Patches) {
+		if (!bin.IsValidRange(patch.Bytes, bin.PatchBytes)) {
+			ERR("Compiled binary mappings are corrupted");
+			return false;
+		}
+	}
+
+	for (auto const& imp : bin.DllImports) {
+		if (!bin.IsValidString(imp.Symbol) || !bin.IsValidString(imp.Module) || !bin.IsValidString(imp.Proc)) {
+			ERR("Compiled binary mappings are corrupted");
+			return false;
+		}
+	}
+
+	mappings_.SourceHash = HashBytes(reinterpret_cast<uint8_t const*>(blob.data()), blob.size());
+
+	for (auto const& mapping : bin.Mappings) {
+		SymbolMappings::Mapping sym;
+		if (LoadCompiledMapping(bin, mapping, sym)) {
+			if (mappings_.Mappings.find(sym.Name) != mappings_.Mappings.end()) {
+				ERR("Duplicate mapping name: %s", sym.Name.c_str());
+			}
+
+			mappings_.Mappings.insert(std::make_pair(sym.Name, sym));
+		} else {
+			ERR("Failed to load mapping '%s'; mapping discarded", sym.Name.c_str());
+		}
+	}
+
+	for (auto const& mapping : bin.DllImports) {
+		SymbolMappings::DllImport imp;
+		if (LoadCompiledDllImport(bin, mapping, imp)) {
+			mappings_.DllImports.insert(std::make_pair(imp.Symbol, imp));
+		}
+	}
+
+	return true;
+}
+
+bool SymbolMappingLoader::LoadCompiledMapping(CompiledMappings const& bin, binmap::Mapping const& mapping, SymbolMappings::Mapping& sym)
+{
+	if (mapping.Name == binmap::NoString) {
+		ERR("Mapping must have a name");
+		return false;
+	}
+
+	sym.Name = bin.GetString(mapping.Name);
+	sym.Scope = (SymbolMappings::MatchScope)mapping.Scope;
+	sym.Flag = mapping.Flags;
+
+	if (sym.Scope != SymbolMappings::MatchScope::kCustom) {
+		auto mod = bin.GetString(mapping.Module);
+		if (mod == nullptr || knownModules_.find(mod) == knownModules_.end()) {
+			ERR("Mapping references unknown module: %s", mod ? mod : "(null)");
+			return false;
+		}
+
+		sym.Module = mod;
+	}
+
+	sym.Pattern.FromCompiled(bin.PatternBytes.subspan(mapping.Pattern.Offset, mapping.Pattern.Count));
+
+	for (auto const& ele : bin.Targets.subspan(mapping.Targets.Offset, mapping.Targets.Count)) {
+		SymbolMappings::Target target;
+		if (LoadCompiledTarget(bin, ele, target)) {
+			sym.Targets.push_back(target);
+		}
+	}
+
+	for (auto const& ele : bin.Patches.subspan(mapping.Patches.Offset, mapping.Patches.Count)) {
+		SymbolMappings::Patch patch;
+		patch.Ref.Type = (SymbolMappings::ReferenceType)ele.Ref.Type;
+		patch.Ref.Offset = ele.Ref.Offset;
+		auto bytes = bin.PatchBytes.subspan(ele.Bytes.Offset, ele.Bytes.Count);
+		patch.Bytes.assign(bytes.begin(), bytes.end());
+		sym.Patches.push_back(patch);
+	}
+
+	for (auto const& ele : bin.Conditions.subspan(mapping.Conditions.Offset, mapping.Conditions.Count)) {
+		SymbolMappings::Condition condition;
+		condition.Type = (SymbolMappings::MatchType)ele.Type;
+		condition.Offset = ele.Offset;
+		condition.String = bin.GetString(ele.Value);
+		if (condition.Type == SymbolMappings::MatchType::kWString) {
+			condition.WString = FromStdUTF8(condition.String).c_str();
+		}
+		sym.Conditions.push_back(condition);
+	}
+
+	if (sym.Targets.empty() && sym.Patches.empty()) {
+		ERR("Mapping '%s' has no valid targets or patches!", sym.Name.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool SymbolMappingLoader::LoadCompiledDllImport(CompiledMappings const& bin, binmap::DllImport const& mapping, SymbolMappings::DllImport& imp)
+{
+	auto staticSymbol = bin.GetString(mapping.Symbol);
+	auto symIt = mappings_.StaticSymbols.find(staticSymbol);
+	if (symIt != mappings_.StaticSymbols.end()) {
+		imp.TargetRef = StaticSymbolRef(symIt->second.Offset);
+		symIt->second.Bound = true;
+	} else {
+		ERR("DllImport references nonexistent engine symbol: '%s'", staticSymbol);
+		return false;
+	}
+
+	imp.Symbol = staticSymbol;
+	imp.Module = bin.GetString(mapping.Module);
+	imp.Proc = bin.GetString(mapping.Proc);
+	return true;
+}
+
+bool SymbolMappingLoader::LoadCompiledTarget(CompiledMappings const& bin, binmap::Target const& ele, SymbolMappings::Target& target)
+{
+	target.Name = bin.GetString(ele.Name);
+	target.Ref.Type = (SymbolMappings::ReferenceType)ele.Ref.Type;
+	target.Ref.Offset = ele.Ref.Offset;
+
+	auto staticSymbol = bin.GetString(ele.Symbol);
+	if (staticSymbol) {
+		auto symIt = mappings_.StaticSymbols.find(staticSymbol);
+		if (symIt != mappings_.StaticSymbols.end()) {
+			target.TargetRef = StaticSymbolRef(symIt->second.Offset);
+			symIt->second.Bound = true;
+		} else {
+			ERR("Mapping target references nonexistent engine symbol: '%s'", staticSymbol);
+			return false;
+		}
+	}
+
+	auto nextSymbol = bin.GetString(ele.NextSymbol);
+	if (nextSymbol) {
+		target.NextSymbol = nextSymbol;
+		if (mappings_.Mappings.find(nextSymbol) == mappings_.Mappings.end()) {
+			ERR("Mapping target references nonexistent symbol mapping: '%s'", nextSymbol);
+			return false;
+		}
+
+		target.NextSymbolSeekSize = ele.NextSymbolSeekSize;
+	}
+
+	auto engineCallback = bin.GetString(ele.EngineCallback);
+	if (engineCallback) {
+		target.EngineCallback = engineCallback;
+	}
+
+	return true;
+}
+
 bool SymbolMapper::IsValidModulePtr(uint8_t const * ref) const
 {
 	for (auto const& mod : modules_) {
@@ -833,25 +1383,22 @@ bool SymbolMapper::MapSymbol(std::string const& mappingName, uint8_t const* cust
 	return MapSymbol(mapping->second, customStart, customSize);
 }
 
-bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const * customStart, std::size_t customSize)
+bool SymbolMapper::IsMappingSupported(SymbolMappings::Mapping const& mapping) const
 {
-	if (mapping.Version.Type != SymbolMappings::SymbolVersion::None) {
-		bool passed;
-		if (mapping.Version.Type == SymbolMappings::SymbolVersion::Below) {
-			passed = gameRevision_ < mapping.Version.Revision;
-		} else {
-			passed = gameRevision_ >= mapping.Version.Revision;
-		}
-
-		if (!passed) {
-			// Ignore mappings that aren't supported by the current game version
-			return true;
-		}
+	if (mapping.Version.Type == SymbolMappings::SymbolVersion::None) {
+		return true;
 	}
 
-	uint8_t const * memStart;
-	std::size_t memSize;
+	if (mapping.Version.Type == SymbolMappings::SymbolVersion::Below) {
+		return gameRevision_ < mapping.Version.Revision;
+	} else {
+		return gameRevision_ >= mapping.Version.Revision;
+	}
+}
 
+bool SymbolMapper::GetMappingScope(SymbolMappings::Mapping const& mapping, uint8_t const* customStart, std::size_t customSize,
+	uint8_t const*& memStart, std::size_t& memSize) const
+{
 	if (mapping.Scope == SymbolMappings::MatchScope::kBinary || mapping.Scope == SymbolMappings::MatchScope::kText) {
 		auto modIt = modules_.find(mapping.Module);
 		if (modIt == modules_.end()) {
@@ -879,55 +1426,49 @@ bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const *
 		return false;
 	}
 
-#if defined(DEBUG_MAPPINGS)
-	DEBUG("Try mapping: %s [%p -> %p]", mapping.Name.c_str(), memStart, memStart + memSize);
-#endif
+	return true;
+}
 
-	bool mapped = false,
-		hasMatches = false;
-	mapping.Pattern.Scan(memStart, memSize, [this, &mapping, &mapped, &hasMatches](const uint8_t * match) -> Pattern::ScanAction {
-		bool matching{ true };
-		for (auto const& condition : mapping.Conditions) {
-			if (!EvaluateSymbolCondition(condition, match)) {
-				matching = false;
-				break;
-			}
+Pattern::ScanAction SymbolMapper::ProcessMatch(SymbolMappings::Mapping& mapping, uint8_t const* match, bool& mapped, bool& hasMatches)
+{
+	for (auto const& condition : mapping.Conditions) {
+		if (!EvaluateSymbolCondition(condition, match)) {
+			return Pattern::ScanAction::Continue;
 		}
+	}
 
-		if (matching) {
 #if defined(DEBUG_MAPPINGS)
-			DEBUG("\tMatch: [%p]", match);
+	DEBUG("\tMatch: [%p]", match);
 #endif
 
-			hasMatches = true;
-			auto patternAction{ Pattern::ScanAction::Finish };
-			for (auto const& target : mapping.Targets) {
-				auto action = ExecSymbolMappingAction(target, match);
+	hasMatches = true;
+	auto patternAction{ Pattern::ScanAction::Finish };
+	for (auto const& target : mapping.Targets) {
+		auto action = ExecSymbolMappingAction(target, match);
 #if defined(DEBUG_MAPPINGS)
-				DEBUG("\tAction: %s", (action == MappingResult::Success) ? "Success"
-					: ((action == MappingResult::TryNext) ? "TryNext" : "Fail"));
+		DEBUG("\tAction: %s", (action == MappingResult::Success) ? "Success"
+			: ((action == MappingResult::TryNext) ? "TryNext" : "Fail"));
 #endif
 
-				if (!mapped) {
-					mapped = (action == MappingResult::Success);
-				}
-				if (action == MappingResult::TryNext) {
-					patternAction = Pattern::ScanAction::Continue;
-				}
-			}
-
-			for (auto& patch : mapping.Patches) {
-				if (UpdatePatchReference(patch, match)) {
-					mapped = true;
-				}
-			}
+		if (!mapped) {
+			mapped = (action == MappingResult::Success);
+		}
+		if (action == MappingResult::TryNext) {
+			patternAction = Pattern::ScanAction::Continue;
+		}
+	}
 
-			return patternAction;
-		} else {
-			return {};
+	for (auto& patch : mapping.Patches) {
+		if (UpdatePatchReference(patch, match)) {
+			mapped = true;
 		}
-	});
+	}
 
+	return patternAction;
+}
+
+void SymbolMapper::ReportMappingResult(SymbolMappings::Mapping const& mapping, bool mapped, bool hasMatches)
+{
 	if (!mapped && !(mapping.Flag & SymbolMappings::Mapping::kAllowFail)) {
 		if (!hasMatches) {
 			ERR("No match found for mapping '%s' %s", mapping.Name.c_str(),
@@ -942,7 +1483,32 @@ bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const *
 			hasFailedCriticalMappings_ = true;
 		}
 	}
+}
+
+bool SymbolMapper::MapSymbol(SymbolMappings::Mapping & mapping, uint8_t const * customStart, std::size_t customSize)
+{
+	if (!IsMappingSupported(mapping)) {
+		// Ignore mappings that aren't supported by the current game version
+		return true;
+	}
+
+	uint8_t const * memStart;
+	std::size_t memSize;
+	if (!GetMappingScope(mapping, customStart, customSize, memStart, memSize)) {
+		return false;
+	}
+
+#if defined(DEBUG_MAPPINGS)
+	DEBUG("Try mapping: %s [%p -> %p]", mapping.Name.c_str(), memStart, memStart + memSize);
+#endif
+
+	bool mapped = false,
+		hasMatches = false;
+	mapping.Pattern.Scan(memStart, memSize, [this, &mapping, &mapped, &hasMatches](const uint8_t * match) -> Pattern::ScanAction {
+		return ProcessMatch(mapping, match, mapped, hasMatches);
+	});
 
+	ReportMappingResult(mapping, mapped, hasMatches);
 	return mapped;
 }
 
@@ -1012,6 +1578,10 @@ bool SymbolMapper::AddModule(std::string const& name, std::wstring const& modNam
 	modInfo.ModuleStart = (uint8_t const*)moduleInfo.lpBaseOfDll;
 	modInfo.ModuleSize = moduleInfo.SizeOfImage;
 
+	modInfo.Path.resize(MAX_PATH);
+	DWORD pathLength = GetModuleFileNameW(hLib, modInfo.Path.data(), (DWORD)modInfo.Path.size());
+	modInfo.Path.resize(pathLength);
+
 	// Fallback, if .text segment was not found
 	modInfo.ModuleTextStart = modInfo.ModuleStart;
 	modInfo.ModuleTextSize = modInfo.ModuleSize;
@@ -1036,12 +1606,192 @@ void SymbolMapper::AddEngineCallback(std::string const& name, std::function<Mapp
 	engineCallbacks_.insert(std::make_pair(name, cb));
 }
 
+bool SymbolMapper::GetCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::size_t memSize,
+	std::vector<uint8_t const*>& matches) const
+{
+	auto offsets = cache_.Get(mapping.Name);
+	if (offsets == nullptr) {
+		return false;
+	}
+
+	// Make sure that the pattern still matches at each cached location
+	for (auto offset : *offsets) {
+		if (offset + mapping.Pattern.Size() >= memSize || !mapping.Pattern.MatchPattern(memStart + offset)) {
+			WARN("Cached offsets of mapping '%s' are invalid, falling back to full scan", mapping.Name.c_str());
+			matches.clear();
+			return false;
+		}
+
+		matches.push_back(memStart + offset);
+	}
+
+	return true;
+}
+
+uint64_t SymbolMapper::ComputeCacheKey() const
+{
+	// Hash the on-disk contents of the code and read-only data sections; the loaded image
+	// can't be used as it differs between runs due to relocations and import binding
+	auto hash = HashBytes(reinterpret_cast<uint8_t const*>(&mappings_.SourceHash), sizeof(mappings_.SourceHash));
+
+	std::vector<std::string> moduleNames;
+	for (auto const& mod : modules_) {
+		moduleNames.push_back(mod.first);
+	}
+	std::sort(moduleNames.begin(), moduleNames.end());
+
+	for (auto const& name : moduleNames) {
+		auto const& mod = modules_.find(name)->second;
+		std::ifstream f(mod.Path.c_str(), std::ios::in | std::ios::binary);
+		if (!f.good()) {
+			ERR("SymbolMapper::ComputeCacheKey(): Couldn't open module '%s'", ToUTF8(mod.Path).c_str());
+			return 0;
+		}
+
+		hash = HashBytes(reinterpret_cast<uint8_t const*>(name.data()), name.size(), hash);
+		if (!HashModuleSections(mod.ModuleStart, f, hash)) {
+			ERR("SymbolMapper::ComputeCacheKey(): Couldn't read sections of module '%s'", ToUTF8(mod.Path).c_str());
+			return 0;
+		}
+	}
+
+	return hash;
+}
+
+bool SymbolMapper::HashModuleSections(uint8_t const* imageHeaders, std::istream& file, uint64_t& hash)
+{
+	auto pNtHdr = ImageNtHeader(const_cast<uint8_t*>(imageHeaders));
+	if (pNtHdr == nullptr) {
+		return false;
+	}
+
+	std::vector<uint8_t> sectionData;
+	auto pSectionHdr = IMAGE_FIRST_SECTION(pNtHdr);
+	for (std::size_t i = 0; i < pNtHdr->FileHeader.NumberOfSections; i++, pSectionHdr++) {
+		if (memcmp(pSectionHdr->Name, ".text", 6) == 0 || memcmp(pSectionHdr->Name, ".rdata", 7) == 0) {
+			sectionData.resize(pSectionHdr->SizeOfRawData);
+			file.seekg(pSectionHdr->PointerToRawData, std::ios::beg);
+			file.read(reinterpret_cast<char*>(sectionData.data()), sectionData.size());
+			if (!file.good()) {
+				return false;
+			}
+
+			hash = HashBytes(sectionData.data(), sectionData.size(), hash);
+		}
+	}
+
+	return true;
+}
+
+void SymbolMapper::EnableCache(std::wstring const& path)
+{
+	auto key = ComputeCacheKey();
+	if (key == 0) {
+		ERR("Couldn't compute symbol cache key; symbol cache disabled");
+		return;
+	}
+
+	cachePath_ = path;
+	if (!cache_.Load(path, key)) {
+		DEBUG("Symbol cache missing or outdated, performing full symbol scan");
+	}
+}
+
 void SymbolMapper::MapAllSymbols(bool deferred)
 {
+	struct ScanRange
+	{
+		uint8_t const* Start;
+		std::size_t Size;
+		MultiPatternScanner Scanner;
+	};
+
+	std::vector<SymbolMappings::Mapping*> pending;
+	std::vector<std::optional<std::size_t>> rangeIndices;
+	std::vector<ScanRange> ranges;
+	std::vector<std::vector<uint8_t const*>> matches;
+
 	for (auto& mapping : mappings_.Mappings) {
 		if (mapping.second.Scope != SymbolMappings::MatchScope::kCustom
 			&& deferred == ((mapping.second.Flag & SymbolMappings::Mapping::kDeferred) != 0)) {
-			MapSymbol(mapping.second, nullptr, 0);
+			auto& sym = mapping.second;
+			std::optional<std::size_t> rangeIndex;
+			uint8_t const* memStart;
+			std::size_t memSize;
+			// Mappings that can't be batched are handled by MapSymbol() later on, which also logs the error
+			if (IsMappingSupported(sym) && GetMappingScope(sym, nullptr, 0, memStart, memSize)) {
+				for (std::size_t i = 0; i < ranges.size(); i++) {
+					if (ranges[i].Start == memStart && ranges[i].Size == memSize) {
+						rangeIndex = i;
+						break;
+					}
+				}
+
+				if (!rangeIndex) {
+					rangeIndex = ranges.size();
+					ranges.push_back(ScanRange{ memStart, memSize });
+				}
+
+				std::vector<uint8_t const*> cachedMatches;
+				if (!cachePath_.empty() && GetCachedMatches(sym, memStart, memSize, cachedMatches)) {
+					matches.push_back(std::move(cachedMatches));
+				} else {
+					ranges[*rangeIndex].Scanner.Add(sym.Pattern, (uint32_t)pending.size());
+					matches.push_back({});
+				}
+			} else {
+				matches.push_back({});
+			}
+
+			pending.push_back(&sym);
+			rangeIndices.push_back(rangeIndex);
+		}
+	}
+
+	// Collect candidate matches of every uncached mapping with a single pass over each scan range
+	for (auto& range : ranges) {
+		range.Scanner.Build();
+		range.Scanner.Scan(range.Start, range.Size, [&matches](uint32_t id, uint8_t const* match) {
+			matches[id].push_back(match);
+		});
+	}
+
+	// Process matches in the same order as individual MapSymbol() calls would
+	for (std::size_t i = 0; i < pending.size(); i++) {
+		auto& mapping = *pending[i];
+		if (!rangeIndices[i]) {
+			MapSymbol(mapping, nullptr, 0);
+			continue;
+		}
+
+#if defined(DEBUG_MAPPINGS)
+		DEBUG("Try mapping: %s [%d candidates]", mapping.Name.c_str(), (int)matches[i].size());
+#endif
+
+		bool mapped = false,
+			hasMatches = false;
+		std::size_t processed{ 0 };
+		for (auto match : matches[i]) {
+			processed++;
+			if (ProcessMatch(mapping, match, mapped, hasMatches) == Pattern::ScanAction::Finish) {
+				break;
+			}
+		}
+
+		ReportMappingResult(mapping, mapped, hasMatches);
+
+		if (!cachePath_.empty()) {
+			if (mapped) {
+				// Only matches up to the one that finished the mapping are needed to replay it
+				auto rangeStart = ranges[*rangeIndices[i]].Start;
+				std::vector<uint32_t> offsets;
+				for (std::size_t j = 0; j < processed; j++) {
+					offsets.push_back((uint32_t)(matches[i][j] - rangeStart));
+				}
+				cache_.Set(mapping.Name, std::move(offsets));
+			} else {
+				cache_.Remove(mapping.Name);
+			}
 		}
 	}
 
@@ -1050,6 +1800,10 @@ void SymbolMapper::MapAllSymbols(bool deferred)
 			MapDllImport(imp.second);
 		}
 	}
+
+	if (!cachePath_.empty() && cache_.IsDirty()) {
+		cache_.Save(cachePath_);
+	}
 }
 
 END_SE()
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <GameHooks/Wrappers.h>
+#include <GameHooks/BinaryMappingsFormat.h>
+#include <iosfwd>
 #include <optional>
+#include <span>
 #include <unordered_set>
 
 namespace tinyxml2 {
@@ -47,27 +50,77 @@ struct Pattern
 		Finish
 	};
 
+	using PatternByte = binmap::PatternByte;
+
+	Pattern() = default;
+	Pattern(Pattern const& o);
+	Pattern(Pattern&& o) = default;
+	Pattern& operator = (Pattern const& o);
+	Pattern& operator = (Pattern&& o) = default;
+
 	bool FromString(std::string_view s);
 	void FromRaw(const char * s);
+	// Uses precompiled pattern bytes in-place; the bytes must outlive the pattern
+	void FromCompiled(std::span<PatternByte const> bytes);
 	void Scan(uint8_t const * start, size_t length, std::function<ScanAction (uint8_t const *)> callback) const;
 	std::optional<uint32_t> GetAnchor(char const* anchor) const;
+	bool MatchPattern(uint8_t const * start) const;
 
-private:
-	struct PatternByte
+	inline std::size_t Size() const
 	{
-		uint8_t pattern;
-		uint8_t mask;
-	};
+		return pattern_.size();
+	}
+
+private:
+	friend class MultiPatternScanner;
 
-	std::vector<PatternByte> pattern_;
+	std::vector<PatternByte> ownedPattern_;
+	// Either points to ownedPattern_ or to precompiled pattern data
+	std::span<PatternByte const> pattern_;
 	std::unordered_map<std::string, uint32_t> anchors_;
 
-	bool MatchPattern(uint8_t const * start) const;
 	void ScanPrefix1(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 	void ScanPrefix2(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 	void ScanPrefix4(uint8_t const * start, uint8_t const * end, std::function<ScanAction (uint8_t const *)> callback) const;
 };
 
+// Scans for multiple patterns in a single pass over a memory region.
+// The longest exact byte run of each pattern is compiled into an Aho-Corasick automaton;
+// wildcard bytes are only checked after the automaton found a candidate match.
+class MultiPatternScanner
+{
+public:
+	void Add(Pattern const& pattern, uint32_t id);
+	void Build();
+	// Reports matches in the same order (and with the same bounds) as Pattern::Scan() would for each pattern
+	void Scan(uint8_t const* start, size_t length, std::function<void (uint32_t, uint8_t const*)> const& callback) const;
+
+private:
+	static constexpr uint32_t MaxKeyLength = 8;
+	static constexpr uint32_t NoTransition = 0xffffffffu;
+
+	struct Entry
+	{
+		Pattern const* Pat;
+		uint32_t Id;
+		uint32_t KeyOffset;
+		uint32_t KeyLength;
+	};
+
+	struct Node
+	{
+		uint32_t Fail{ 0 };
+		std::vector<uint32_t> Outputs;
+	};
+
+	std::vector<Entry> entries_;
+	std::vector<Node> nodes_;
+	// Dense transition table; 256 entries per node
+	std::vector<uint32_t> transitions_;
+
+	uint32_t AddNode();
+};
+
 uint8_t const * AsmResolveInstructionRef(uint8_t const * code);
 
 struct StaticSymbolRef
@@ -206,6 +259,33 @@ struct SymbolMappings
 	std::unordered_map<std::string, Mapping> Mappings;
 	std::unordered_map<std::string, DllImport> DllImports;
 	std::unordered_map<std::string, StaticSymbol> StaticSymbols;
+	// Hash of the mapping definitions the mappings were loaded from
+	uint64_t SourceHash{ 0 };
+};
+
+// On-disk cache of the match offsets of each mapping, relative to the start of the mapping scope.
+// Cache files are only valid for the exact module binaries and mapping definitions they were created with.
+class SymbolMappingCache
+{
+public:
+	bool Load(std::wstring const& path, uint64_t key);
+	bool Save(std::wstring const& path);
+	std::vector<uint32_t> const* Get(std::string const& mapping) const;
+	void Set(std::string const& mapping, std::vector<uint32_t>&& offsets);
+	void Remove(std::string const& mapping);
+
+	inline bool IsDirty() const
+	{
+		return dirty_;
+	}
+
+private:
+	static constexpr uint32_t Magic = 0x4D534F53; // 'SOSM'
+	static constexpr uint32_t Version = 1;
+
+	uint64_t key_{ 0 };
+	std::unordered_map<std::string, std::vector<uint32_t>> entries_;
+	bool dirty_{ false };
 };
 
 class SymbolMappingLoader
@@ -218,11 +298,18 @@ public:
 	void AddKnownModule(std::string const& name);
 	bool LoadBuiltinMappings();
 	bool LoadMappings(tinyxml2::XMLDocument* doc);
+	bool LoadCompiledMappings(std::string_view blob);
 
 private:
+	struct CompiledMappings;
+
 	SymbolMappings& mappings_;
 	std::unordered_set<std::string> knownModules_;
 
+	bool LoadCompiledMapping(CompiledMappings const& bin, binmap::Mapping const& mapping, SymbolMappings::Mapping& sym);
+	bool LoadCompiledDllImport(CompiledMappings const& bin, binmap::DllImport const& mapping, SymbolMappings::DllImport& imp);
+	bool LoadCompiledTarget(CompiledMappings const& bin, binmap::Target const& ele, SymbolMappings::Target& target);
+
 	bool LoadMappingsNode(tinyxml2::XMLElement* mappingsNode);
 	bool LoadMapping(tinyxml2::XMLElement* mapping, SymbolMappings::Mapping& sym);
 	bool LoadDllImport(tinyxml2::XMLElement* mapping, SymbolMappings::DllImport& imp);
@@ -249,6 +336,7 @@ public:
 		size_t ModuleSize{ 0 };
 		uint8_t const* ModuleTextStart{ nullptr };
 		size_t ModuleTextSize{ 0 };
+		std::wstring Path;
 	};
 
 	inline SymbolMapper(SymbolMappings& mappings)
@@ -261,6 +349,11 @@ public:
 	bool MapSymbol(std::string const& mappingName, uint8_t const* customStart, std::size_t customSize);
 	bool MapSymbol(SymbolMappings::Mapping& mapping, uint8_t const* customStart, std::size_t customSize);
 	bool MapDllImport(SymbolMappings::DllImport const& imp);
+	// Loads cached mapping offsets; newly resolved offsets are written back to the same file
+	void EnableCache(std::wstring const& path);
+	// Hashes the on-disk .text and .rdata sections of a module into the cache key.
+	// Section locations are taken from the headers of the image; the section contents are read from the file.
+	static bool HashModuleSections(uint8_t const* imageHeaders, std::istream& file, uint64_t& hash);
 
 	inline bool HasFailedCriticalMappings() const
 	{
@@ -284,13 +377,24 @@ private:
 	uint32_t gameRevision_;
 	bool hasFailedMappings_{ false };
 	bool hasFailedCriticalMappings_{ false };
+	SymbolMappingCache cache_;
+	std::wstring cachePath_;
 
+	uint64_t ComputeCacheKey() const;
+	bool GetCachedMatches(SymbolMappings::Mapping const& mapping, uint8_t const* memStart, std::size_t memSize,
+		std::vector<uint8_t const*>& matches) const;
 	bool IsValidModulePtr(uint8_t const* ref) const;
 	bool IsConstStringRef(uint8_t const* ref, char const* str) const;
 	bool IsConstWStringRef(uint8_t const* ref, wchar_t const* str) const;
 	bool IsFixedStringRef(uint8_t const* ref, char const* str) const;
 	bool IsIndirectFixedStringRef(uint8_t const* ref, char const* str) const;
 
+	bool GetMappingScope(SymbolMappings::Mapping const& mapping, uint8_t const* customStart, std::size_t customSize,
+		uint8_t const*& memStart, std::size_t& memSize) const;
+	bool IsMappingSupported(SymbolMappings::Mapping const& mapping) const;
+	Pattern::ScanAction ProcessMatch(SymbolMappings::Mapping& mapping, uint8_t const* match, bool& mapped, bool& hasMatches);
+	void ReportMappingResult(SymbolMappings::Mapping const& mapping, bool mapped, bool hasMatches);
+
 	std::optional<uint8_t const*> ResolveRef(SymbolMappings::Reference const& ref, uint8_t const* match);
 	bool EvaluateSymbolCondition(SymbolMappings::Condition const& cond, uint8_t const* match);
 	MappingResult ExecSymbolMappingAction(SymbolMappings::Target const& target, uint8_t const* match);
@@ -394,7 +394,7 @@ namespace dse::lua::dbg
 
 	void DebugMessageHandler::HandleGetVariables(uint32_t seq, DbgGetVariables const& req)
 	{
-		DEBUG(" --> DbgGetVariables(%d, %d, %d)", req.variableref(), req.frame(), req.local());
+		DEBUG(" --> DbgGetVariables(%d, %d, %d, %d, %d)", req.variableref(), req.frame(), req.local(), req.start(), req.count());
 
 		if (!debugger_) {
 			WARN("GetVariables: Not attached to story debugger!");
@@ -417,6 +417,9 @@ namespace dse::lua::dbg
 		varsReq.VariablesRef = req.variableref();
 		varsReq.Frame = req.frame();
 		varsReq.Local = req.local();
+		varsReq.Start = req.start();
+		varsReq.Count = req.count();
+		varsReq.Filter = req.filter();
 
 		for (auto const& key : req.key()) {
 			DebuggerGetVariablesRequest::KeyType ele;
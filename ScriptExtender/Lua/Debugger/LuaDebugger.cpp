@@ -16,6 +16,15 @@ namespace dse::lua::dbg
 		: messageHandler_(messageHandler), context_(ctx)
 	{}
 
+	// The count hook makes sure that pause requests and queued actions are processed
+	// even if the running function never calls or returns from another function
+	constexpr int HookInstructionCount = 10000;
+	constexpr int BaseHookMask = LUA_MASKCALL | LUA_MASKRET | LUA_MASKCOUNT;
+	// Upper bound on the number of chunks whose breakpoint lines are cached
+	constexpr std::size_t MaxCachedChunks = 4096;
+	// Upper bound on the number of children returned in a single variables response
+	constexpr uint32_t MaxVariablesPageSize = 1000;
+
 	void LuaHook(lua_State* L, lua_Debug* ar)
 	{
 		gExtender->GetLuaDebugger()->OnLuaHook(L, ar);
@@ -40,16 +49,21 @@ namespace dse::lua::dbg
 		return proto->lineinfo ? proto->lineinfo[pc] : -1;
 	}
 
-	int LuaGetStackDepth(lua_State* L)
+	int LuaGetStackDepth(lua_State* L, CallInfo* top)
 	{
 		int depth = 0;
-		for (auto ci = L->ci; ci != &L->base_ci; ci = ci->previous) {
+		for (auto ci = top; ci != &L->base_ci; ci = ci->previous) {
 			depth++;
 		}
 
 		return depth;
 	}
 
+	int LuaGetStackDepth(lua_State* L)
+	{
+		return LuaGetStackDepth(L, L->ci);
+	}
+
 	void ObjectHandleToProtobuf(ComponentHandle const& handle, MsgValue* value)
 	{
 		value->set_type_id(MsgValueType::COMPONENT_HANDLE);
@@ -103,6 +117,8 @@ namespace dse::lua::dbg
 			value->set_type_id(MsgValueType::FUNCTION);
 			break;
 		case LUA_TUSERDATA:
+		case LUA_TLIGHTCPPOBJECT:
+		case LUA_TCPPOBJECT:
 			value->set_type_id(MsgValueType::USERDATA);
 			value->set_stringval(luaL_tolstring(L, idx, nullptr));
 			lua_pop(L, 1);
@@ -116,12 +132,73 @@ namespace dse::lua::dbg
 		}
 	}
 
+	// Checks whether the userdata or object proxy at the specified index has a __pairs metamethod
+	bool LuaHasPairs(lua_State* L, int idx)
+	{
+		switch (lua_type(L, idx)) {
+		case LUA_TUSERDATA:
+		{
+			auto type = luaL_getmetafield(L, idx, "__pairs");
+			if (type == LUA_TNIL) {
+				return false;
+			}
+
+			lua_pop(L, 1);
+			return true;
+		}
+
+		case LUA_TLIGHTCPPOBJECT:
+		case LUA_TCPPOBJECT:
+		{
+			CppObjectMetadata meta;
+			lua_get_cppobject(L, idx, meta);
+			auto mt = State::FromLua(L)->GetMetatableManager().GetMetatable(meta.MetatableTag);
+			if (lua_cmetatable_push(L, mt, (int)MetamethodName::Pairs)) {
+				lua_pop(L, 1);
+				return true;
+			}
+
+			return false;
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	// Tables and iterable object proxies can be expanded in the debugger; children of proxies are only
+	// fetched (through __pairs) when the frontend requests them
+	bool LuaIsExpandable(lua_State* L, int idx, MsgValue const* value)
+	{
+		switch (value->type_id()) {
+		case MsgValueType::TABLE:
+			return true;
+
+		case MsgValueType::USERDATA:
+			return LuaHasPairs(L, idx);
+
+		default:
+			return false;
+		}
+	}
+
+	MsgVariablesRef* LuaMakeVariablesRef(lua_State* L, int idx, MsgValue* value)
+	{
+		auto ref = value->mutable_variables();
+		if (lua_type(L, idx) == LUA_TTABLE) {
+			// Hint for the frontend to request large arrays in pages
+			ref->set_indexed_count((int32_t)std::min(lua_rawlen(L, idx), (size_t)0x7fffffff));
+		}
+
+		return ref;
+	}
+
 	void LuaToProtobuf(lua_State* L, int idx, MsgValue* value, DebuggerGetVariablesRequest const& req)
 	{
 		LuaToProtobuf(L, idx, value);
 
-		if (value->type_id() == MsgValueType::TABLE) {
-			auto ref = value->mutable_variables();
+		if (LuaIsExpandable(L, idx, value)) {
+			auto ref = LuaMakeVariablesRef(L, idx, value);
 			ref->set_frame(req.Frame);
 			ref->set_local(req.Local);
 			ref->set_variableref(req.VariablesRef);
@@ -160,8 +237,8 @@ namespace dse::lua::dbg
 
 					auto val = var->mutable_value();
 					LuaToProtobuf(L, -1, val);
-					if (val->type_id() == MsgValueType::TABLE) {
-						auto ref = val->mutable_variables();
+					if (LuaIsExpandable(L, -1, val)) {
+						auto ref = LuaMakeVariablesRef(L, -1, val);
 						ref->set_frame(frame);
 						ref->set_local(localIdx);
 						ref->set_variableref(-1);
@@ -186,8 +263,8 @@ namespace dse::lua::dbg
 
 				auto val = var->mutable_value();
 				LuaToProtobuf(L, -1, val);
-				if (val->type_id() == MsgValueType::TABLE) {
-					auto ref = val->mutable_variables();
+				if (LuaIsExpandable(L, -1, val)) {
+					auto ref = LuaMakeVariablesRef(L, -1, val);
 					ref->set_frame(frame);
 					ref->set_local(-i - 1);
 					ref->set_variableref(-1);
@@ -238,39 +315,226 @@ namespace dse::lua::dbg
 		lua_remove(L, funcIdx);
 	}
 
-	void LuaTableToEvalResults(lua_State* L, int index, DebuggerGetVariablesRequest const& req)
+	// Adds the key/value pair at the top of the stack to the variables response
+	void LuaChildToEvalResults(lua_State* L, DebuggerGetVariablesRequest const& req)
 	{
-		for (auto idx : iterate(L, index)) {
-			auto pair = req.Response->add_result();
+		auto pair = req.Response->add_result();
+		switch (lua_type(L, -2)) {
+		case LUA_TNUMBER:
+			pair->set_type(MsgChildValue::NUMERIC);
+			pair->set_index(lua_tointeger(L, -2));
+			break;
+
+		case LUA_TSTRING:
+			pair->set_type(MsgChildValue::TEXT);
+			pair->set_name(lua_tostring(L, -2));
+			break;
+		}
+
+		auto val = pair->mutable_value();
+		LuaToProtobuf(L, -1, val, req);
+		if (LuaIsExpandable(L, -1, val)) {
+			auto key = val->mutable_variables()->add_key();
 			switch (lua_type(L, -2)) {
 			case LUA_TNUMBER:
-				pair->set_type(MsgChildValue::NUMERIC);
-				pair->set_index(lua_tointeger(L, -2));
+				key->set_type(MsgTableKey::NUMERIC);
+				key->set_index(lua_tointeger(L, -2));
 				break;
 
 			case LUA_TSTRING:
-				pair->set_type(MsgChildValue::TEXT);
-				pair->set_name(lua_tostring(L, -2));
+				key->set_type(MsgTableKey::TEXT);
+				key->set_key(lua_tostring(L, -2));
 				break;
 			}
+		}
+	}
+
+	// Checks whether the key at the top of the stack passes the filter of the request
+	bool LuaKeyMatchesFilter(lua_State* L, DebuggerGetVariablesRequest const& req, lua_Integer arrayLength)
+	{
+		if (req.Filter == DbgGetVariables::ALL) {
+			return true;
+		}
+
+		bool isIndexed = lua_isinteger(L, -2)
+			&& lua_tointeger(L, -2) >= 1
+			&& (arrayLength < 0 || lua_tointeger(L, -2) <= arrayLength);
+		return isIndexed == (req.Filter == DbgGetVariables::INDEXED);
+	}
+
+	uint32_t LuaGetVariablesPageSize(DebuggerGetVariablesRequest const& req)
+	{
+		return (req.Count == 0 || req.Count > MaxVariablesPageSize) ? MaxVariablesPageSize : req.Count;
+	}
+
+	// The client pages children itself when it sends a count, so the result is only reported as
+	// truncated when our own page size limit cut it shorter than what was requested
+	void LuaSetVariablesTruncated(DebuggerGetVariablesRequest const& req)
+	{
+		if (req.Count == 0 || req.Count > MaxVariablesPageSize) {
+			req.Response->set_has_more(true);
+		}
+	}
+
+	void LuaTableToEvalResults(lua_State* L, int index, DebuggerGetVariablesRequest const& req)
+	{
+		index = lua_absindex(L, index);
+		auto pageSize = LuaGetVariablesPageSize(req);
+		auto arrayLength = (lua_Integer)lua_rawlen(L, index);
+
+		if (req.Filter == DbgGetVariables::INDEXED) {
+			// Array elements can be fetched directly without traversing the table
+			auto last = std::min((lua_Integer)req.Start + pageSize, arrayLength);
+			for (auto i = (lua_Integer)req.Start + 1; i <= last; i++) {
+				push(L, i); // stack: key
+				lua_rawgeti(L, index, i); // stack: key, value
+				LuaChildToEvalResults(L, req);
+				lua_pop(L, 2);
+			}
 
-			auto val = pair->mutable_value();
-			LuaToProtobuf(L, -1, val, req);
-			if (val->type_id() == MsgValueType::TABLE) {
-				auto key = val->mutable_variables()->add_key();
-				switch (lua_type(L, -2)) {
-				case LUA_TNUMBER:
-					key->set_type(MsgTableKey::NUMERIC);
-					key->set_index(lua_tointeger(L, -2));
+			if (last < arrayLength) {
+				LuaSetVariablesTruncated(req);
+			}
+			return;
+		}
+
+		// Only the requested page is serialized; preceding entries are skipped without conversion
+		uint32_t position{ 0 };
+		uint32_t added{ 0 };
+		lua_pushnil(L); // stack: key
+		while (lua_next(L, index) != 0) { // stack: key, value
+			if (LuaKeyMatchesFilter(L, req, arrayLength) && position++ >= req.Start) {
+				if (added >= pageSize) {
+					LuaSetVariablesTruncated(req);
+					lua_pop(L, 2);
 					break;
+				}
 
-				case LUA_TSTRING:
-					key->set_type(MsgTableKey::TEXT);
-					key->set_key(lua_tostring(L, -2));
+				LuaChildToEvalResults(L, req);
+				added++;
+			}
+
+			lua_pop(L, 1); // stack: key
+		}
+	}
+
+	// Enumerates the children of an object proxy using its __pairs metamethod.
+	// The iterator runs in protected mode, as an error (eg. an expired lifetime) must not unwind
+	// through the debug hook while the game thread is paused.
+	bool LuaProxyToEvalResults(lua_State* L, int index, DebuggerGetVariablesRequest const& req)
+	{
+		index = lua_absindex(L, index);
+		auto top = lua_gettop(L);
+		auto pageSize = LuaGetVariablesPageSize(req);
+
+		lua_getglobal(L, "pairs");
+		lua_pushvalue(L, index);
+		if (lua_pcall(L, 1, 3, 0) != LUA_OK) { // stack: next, obj, key
+			auto err = lua_tostring(L, -1);
+			req.Response->set_error_message(err ? err : "Failed to iterate object");
+			lua_settop(L, top);
+			return false;
+		}
+
+		auto nextIdx = top + 1;
+		uint32_t position{ 0 };
+		uint32_t added{ 0 };
+		bool succeeded{ true };
+		for (;;) {
+			lua_pushvalue(L, nextIdx);
+			lua_pushvalue(L, nextIdx + 1);
+			lua_pushvalue(L, -3);
+			if (lua_pcall(L, 2, 2, 0) != LUA_OK) { // stack: next, obj, key, newKey, value
+				auto err = lua_tostring(L, -1);
+				req.Response->set_error_message(err ? err : "Failed to iterate object");
+				succeeded = false;
+				break;
+			}
+
+			lua_remove(L, -3); // stack: next, obj, newKey, value
+			if (lua_type(L, -2) == LUA_TNIL) {
+				break;
+			}
+
+			if (LuaKeyMatchesFilter(L, req, -1) && position++ >= req.Start) {
+				if (added >= pageSize) {
+					LuaSetVariablesTruncated(req);
 					break;
 				}
+
+				LuaChildToEvalResults(L, req);
+				added++;
+			}
+
+			lua_pop(L, 1); // stack: next, obj, newKey
+		}
+
+		lua_settop(L, top);
+		return succeeded;
+	}
+
+	ContextDebugger::ChunkBreakpoints const* ContextDebugger::GetChunkBreakpoints(lua_State* L, CallInfo* ci)
+	{
+		if (!breakpoints_ || !LuaIsUserFunction(L, ci) || !ttisLclosure(ci->func)) {
+			return nullptr;
+		}
+
+		auto source = clLvalue(ci->func)->p->source;
+		if (source == nullptr) {
+			return nullptr;
+		}
+
+		auto sourceLen = tsslen(source);
+		auto it = chunks_.find(source);
+		if (it != chunks_.end()
+			&& it->second.Source.size() == sourceLen
+			&& memcmp(it->second.Source.data(), getstr(source), sourceLen) == 0) {
+			return it->second.Lines.empty() ? nullptr : &it->second;
+		}
+
+		if (chunks_.size() >= MaxCachedChunks) {
+			chunks_.clear();
+		}
+
+		auto& chunk = chunks_[source];
+		chunk.Source.assign(getstr(source), sourceLen);
+		chunk.Lines.clear();
+
+		auto const& paths = GetExtensionState().GetLoadedFileFullPaths();
+		auto pathIt = paths.find(chunk.Source);
+		if (pathIt != paths.end()) {
+			auto fileIt = breakpoints_->breakpoints.find(pathIt->second);
+			if (fileIt != breakpoints_->breakpoints.end()) {
+				for (auto line : fileIt->second) {
+					if (line < 0) continue;
+
+					auto word = (std::size_t)line / 64;
+					if (chunk.Lines.size() <= word) {
+						chunk.Lines.resize(word + 1);
+					}
+					chunk.Lines[word] |= 1ull << (line % 64);
+				}
 			}
 		}
+
+		return chunk.Lines.empty() ? nullptr : &chunk;
+	}
+
+	bool ContextDebugger::NeedsLineHook(lua_State* L, CallInfo* ci)
+	{
+		if (requestPause_ && LuaGetStackDepth(L, ci) <= pauseMaxStackDepth_) {
+			return true;
+		}
+
+		return GetChunkBreakpoints(L, ci) != nullptr;
+	}
+
+	void ContextDebugger::SetLineHook(lua_State* L, bool enabled)
+	{
+		auto mask = BaseHookMask | (enabled ? LUA_MASKLINE : 0);
+		if (lua_gethookmask(L) != mask) {
+			lua_sethook(L, LuaHook, mask, HookInstructionCount);
+		}
 	}
 
 	bool ContextDebugger::IsBreakpoint(lua_State* L, lua_Debug* ar, BkBreakpointTriggered::Reason& reason)
@@ -280,7 +544,7 @@ namespace dse::lua::dbg
 			return false;
 		}
 
-		int line;
+		int line{ -1 };
 		if (LuaIsUserFunction(L)) {
 			line = LuaCurrentLine(L->ci);
 			if (line == -1) {
@@ -302,33 +566,10 @@ namespace dse::lua::dbg
 		}
 
 		if (breakpoints_) {
-			auto lineIt = breakpoints_->lines.find(line);
-			if (lineIt == breakpoints_->lines.end()) {
-				return false;
-			}
-
-			if (lua_getinfo(L, "fnSl", ar) == 0) {
-				return false;
-			}
-
-
-			ExtensionStateBase* state{ nullptr };
-			if (context_ == DbgContext::SERVER) {
-				state = &gExtender->GetServer().GetExtensionState();
-			} else {
-				state = &gExtender->GetClient().GetExtensionState();
-			}
-
-			auto pathIt = state->GetLoadedFileFullPaths().find(ar->source);
-			if (pathIt != state->GetLoadedFileFullPaths().end()) {
-				auto fileIt = breakpoints_->breakpoints.find(pathIt->second);
-				if (fileIt != breakpoints_->breakpoints.end()) {
-					auto lineIt = fileIt->second.find(line);
-					if (lineIt != fileIt->second.end()) {
-						reason = BkBreakpointTriggered::BREAKPOINT;
-						return true;
-					}
-				}
+			auto chunk = GetChunkBreakpoints(L, L->ci);
+			if (chunk != nullptr && chunk->HasLine(line)) {
+				reason = BkBreakpointTriggered::BREAKPOINT;
+				return true;
 			}
 		}
 
@@ -358,15 +599,42 @@ namespace dse::lua::dbg
 		}
 
 		DEBUG("Continuing from breakpoint.");
+
+		// Stepping needs line events in the current function even if it has no breakpoints
+		if (requestPause_ && lua_gethook(L) == LuaHook) {
+			SetLineHook(L, true);
+		}
 	}
 
 	void ContextDebugger::OnLuaHook(lua_State* L, lua_Debug* ar)
 	{
 		ExecuteQueuedActions();
-		
-		BkBreakpointTriggered::Reason reason = BkBreakpointTriggered::BREAKPOINT;
-		if (IsBreakpoint(L, ar, reason)) {
-			TriggerBreakpoint(L, reason, nullptr);
+
+		// Line events are only requested while inside a function that we may break in;
+		// call/return events arm or disarm the line hook when the active function changes.
+		switch (ar->event) {
+		case LUA_HOOKCALL:
+		case LUA_HOOKTAILCALL:
+		case LUA_HOOKCOUNT:
+			SetLineHook(L, NeedsLineHook(L, L->ci));
+			break;
+
+		case LUA_HOOKRET:
+			// Execution continues in the caller once the hook returns
+			if (L->ci != &L->base_ci) {
+				SetLineHook(L, NeedsLineHook(L, L->ci->previous));
+			}
+			break;
+
+		case LUA_HOOKLINE:
+		{
+			BkBreakpointTriggered::Reason reason = BkBreakpointTriggered::BREAKPOINT;
+			if (IsBreakpoint(L, ar, reason)) {
+				TriggerBreakpoint(L, reason, nullptr);
+				SetLineHook(L, NeedsLineHook(L, L->ci));
+			}
+			break;
+		}
 		}
 	}
 
@@ -394,8 +662,9 @@ namespace dse::lua::dbg
 
 	void ContextDebugger::OnContextCreated(lua_State* L)
 	{
+		chunks_.clear();
 		if (enabled_) {
-			lua_sethook(L, LuaHook, LUA_MASKLINE, 0);
+			SetLineHook(L, false);
 		}
 	}
 
@@ -417,7 +686,7 @@ namespace dse::lua::dbg
 		LuaVirtualPin lua(GetExtensionState());
 		if (lua) {
 			if (enabled) {
-				lua_sethook(lua->GetState(), LuaHook, LUA_MASKLINE, 0);
+				SetLineHook(lua->GetState(), false);
 			} else {
 				lua_sethook(lua->GetState(), nullptr, 0, 0);
 			}
@@ -444,8 +713,6 @@ namespace dse::lua::dbg
 		} else {
 			fileIt->second.insert(line);
 		}
-
-		newBreakpoints_->lines.insert(line);
 	}
 
 	void ContextDebugger::FinishUpdatingBreakpoints()
@@ -458,6 +725,7 @@ namespace dse::lua::dbg
 
 		pendingActions_.push([=]() {
 			breakpoints_.reset(bps);
+			chunks_.clear();
 		});
 		breakpointCv_.notify_one();
 	}
@@ -640,7 +908,7 @@ namespace dse::lua::dbg
 
 				if (numReturnValues >= 2) {
 					auto index = (int32_t)lua_tointeger(L, -numReturnValues + 1);
-					auto ref = result->mutable_variables();
+					auto ref = LuaMakeVariablesRef(L, -numReturnValues, result);
 					ref->set_frame(-1);
 					ref->set_local(-1);
 					ref->set_variableref(index);
@@ -750,11 +1018,22 @@ namespace dse::lua::dbg
 				lua_remove(L, -2); // stack: value
 			}
 
-			if (lua_type(L, -1) == LUA_TTABLE) {
+			switch (lua_type(L, -1)) {
+			case LUA_TTABLE:
 				LuaTableToEvalResults(L, -1, req);
 				lua_pop(L, 1);
 				return ResultCode::Success;
-			} else {
+
+			case LUA_TUSERDATA:
+			case LUA_TLIGHTCPPOBJECT:
+			case LUA_TCPPOBJECT:
+			{
+				auto succeeded = LuaProxyToEvalResults(L, -1, req);
+				lua_pop(L, 1);
+				return succeeded ? ResultCode::Success : ResultCode::EvalFailed;
+			}
+
+			default:
 				req.Response->set_error_message("Not a table");
 				lua_pop(L, 1);
 				return ResultCode::EvalFailed;
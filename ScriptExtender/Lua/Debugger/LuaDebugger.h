@@ -10,6 +10,8 @@
 #include <Osiris/Shared/OsirisHelpers.h>
 
 struct lua_Debug;
+struct CallInfo;
+struct TString;
 
 namespace dse
 {
@@ -55,6 +57,10 @@ namespace dse::lua::dbg
 		int Frame;
 		int Local;
 		Vector<KeyType> Key;
+		// Range of children to return
+		uint32_t Start;
+		uint32_t Count;
+		DbgGetVariables::Filter Filter;
 		BkGetVariablesResponse* Response;
 		std::function<void(DebuggerGetVariablesRequest const&, ResultCode)> CompletionCallback;
 	};
@@ -91,8 +97,21 @@ namespace dse::lua::dbg
 		{
 			// Currently active breakpoints
 			std::unordered_map<STDString, std::unordered_set<int>> breakpoints;
-			// Line-only map to avoid string-based file lookup if a specific line has no breakpoints globally
-			std::unordered_set<int> lines;
+		};
+
+		// Breakpoint lines of a single chunk, resolved from the breakpoint set on first use
+		struct ChunkBreakpoints
+		{
+			// Chunk name; used to detect if the cached source string was freed and its address reused
+			STDString Source;
+			// Bitset of lines that have a breakpoint; empty if the chunk has no breakpoints
+			std::vector<uint64_t> Lines;
+
+			inline bool HasLine(int line) const
+			{
+				auto word = (std::size_t)line / 64;
+				return line >= 0 && word < Lines.size() && (Lines[word] & (1ull << (line % 64))) != 0;
+			}
 		};
 
 		DebugMessageHandler& messageHandler_;
@@ -122,10 +141,16 @@ namespace dse::lua::dbg
 		std::unique_ptr<BreakpointSet> breakpoints_;
 		// Breakpoint set being updated through DAP
 		std::unique_ptr<BreakpointSet> newBreakpoints_;
+		// Per-chunk breakpoint lines, keyed by the source string shared by all prototypes of a chunk.
+		// Only accessed from the server/client thread.
+		std::unordered_map<TString const*, ChunkBreakpoints> chunks_;
 
 		ExtensionStateBase& GetExtensionState();
 		void ExecuteQueuedActions();
 		bool IsBreakpoint(lua_State* L, lua_Debug* ar, BkBreakpointTriggered::Reason& reason);
+		ChunkBreakpoints const* GetChunkBreakpoints(lua_State* L, CallInfo* ci);
+		bool NeedsLineHook(lua_State* L, CallInfo* ci);
+		void SetLineHook(lua_State* L, bool enabled);
 		void TriggerBreakpoint(lua_State* L, BkBreakpointTriggered_Reason reason, char const* msg);
 
 		ResultCode EvaluateInContext(DebuggerEvaluateRequest const& req);
@@ -2,43 +2,638 @@
 #include <Lua/Shared/LuaSerializers.h>
 #include <Lua/Shared/LuaMethodHelpers.h>
 #include <Extender/ScriptExtender.h>
+#include <GameHooks/SymbolMapper.h>
+#include <sstream>
 
 /// <lua_module>Debug</lua_module>
 BEGIN_NS(lua::debug)
 
 void DebugDumpLifetimes(lua_State* L)
 {
-	auto const& pool = State::FromLua(L)->GetLifetimePool().GetAllocator();
+	auto const& allocator = State::FromLua(L)->GetLifetimePool().GetAllocator();
 
 	unsigned l1free{ 0 }, l1partial{ 0 }, l1full{ 0 };
 	unsigned l2free{ 0 }, l2partial{ 0 }, l2full{ 0 };
 	unsigned l3free{ 0 }, l3partial{ 0 }, l3full{ 0 };
 	unsigned totalObjs{ 0 };
 
-	for (auto i = 0; i < std::size(pool.l1_); i++) {
-		if (pool.l1_[i] == 0) l1full++;
-		else if (pool.l1_[i] == 0xffffffffffffffffull) l1free++;
-		else l1partial++;
-	}
+	for (auto const& pool : allocator.Segments()) {
+		for (auto i = 0; i < std::size(pool->l1_); i++) {
+			if (pool->l1_[i] == 0) l1full++;
+			else if (pool->l1_[i] == 0xffffffffffffffffull) l1free++;
+			else l1partial++;
+		}
 
-	for (auto i = 0; i < std::size(pool.l2_); i++) {
-		if (pool.l2_[i] == 0) l2full++;
-		else if (pool.l2_[i] == 0xffffffffffffffffull) l2free++;
-		else l2partial++;
-	}
+		for (auto i = 0; i < std::size(pool->l2_); i++) {
+			if (pool->l2_[i] == 0) l2full++;
+			else if (pool->l2_[i] == 0xffffffffffffffffull) l2free++;
+			else l2partial++;
+		}
 
-	for (auto i = 0; i < std::size(pool.l3_); i++) {
-		if (pool.l3_[i] == 0) l3full++;
-		else if (pool.l3_[i] == 0xffffffffffffffffull) l3free++;
-		else l3partial++;
-		totalObjs += (unsigned)_mm_popcnt_u64(pool.l3_[i]);
+		for (auto i = 0; i < std::size(pool->l3_); i++) {
+			if (pool->l3_[i] == 0) l3full++;
+			else if (pool->l3_[i] == 0xffffffffffffffffull) l3free++;
+			else l3partial++;
+			totalObjs += (unsigned)_mm_popcnt_u64(pool->l3_[i]);
+		}
 	}
 
 	std::cout << " === LIFETIME STATS === " << std::endl;
+	std::cout << "Segments: " << allocator.Segments().size() << std::endl;
 	std::cout << "L1: " << l1free << " free pages, " << l1partial << " partially saturated pages, " << l1full << " full pages" << std::endl;
 	std::cout << "L2: " << l2free << " free pages, " << l2partial << " partially saturated pages, " << l2full << " full pages" << std::endl;
 	std::cout << "L3: " << l3free << " free pages, " << l3partial << " partially saturated pages, " << l3full << " full pages" << std::endl;
-	std::cout << "Objects: " << 262144 << " in pool, " << totalObjs << " free" << std::endl;
+	std::cout << "Objects: " << allocator.Capacity() << " in pool, " << totalObjs << " free" << std::endl;
+}
+
+// Development-only stress test for the lifetime pool.
+// Allocates and releases lifetimes in nested scopes on a separate pool, so the lifetimes used by the state are not affected.
+void BenchmarkLifetimes(std::optional<uint32_t> iterations, std::optional<uint32_t> scopeSize)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("BenchmarkLifetimes() only supported in developer mode");
+		return;
+	}
+
+	auto numIterations = iterations.value_or(10);
+	// Large enough by default to force the pool to grow past several segments
+	auto numPerScope = scopeSize.value_or(100000);
+	constexpr unsigned NestingDepth = 8;
+
+	auto pool = std::make_unique<LifetimePool>();
+	Vector<LifetimeHandle> handles;
+	handles.reserve((std::size_t)numPerScope * NestingDepth);
+	std::size_t maxCapacity{ 0 }, totalAllocations{ 0 }, failedAllocations{ 0 }, staleHandles{ 0 }, shrinkFailures{ 0 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t iter = 0; iter < numIterations; iter++) {
+		std::size_t iterCapacity{ 0 };
+		// Enter nested scopes; each scope allocates a batch of lifetimes
+		for (unsigned depth = 0; depth < NestingDepth; depth++) {
+			for (uint32_t i = 0; i < numPerScope; i++) {
+				auto handle = pool->Allocate();
+				if (!handle) {
+					failedAllocations++;
+				}
+				handles.push_back(handle);
+			}
+
+			totalAllocations += numPerScope;
+			iterCapacity = std::max(iterCapacity, pool->GetAllocator().Capacity());
+
+			// Release every other lifetime of the scope early to fragment the bitmaps
+			for (std::size_t i = handles.size() - numPerScope; i < handles.size(); i += 2) {
+				pool->Release(handles[i]);
+				handles[i] = LifetimeHandle{};
+			}
+		}
+
+		// Leave scopes in reverse order
+		while (!handles.empty()) {
+			auto handle = handles.back();
+			if (handle) {
+				pool->Release(handle);
+				// Released handles must not resolve anymore, even if the slot was reused
+				if (pool->IsAlive(handle)) {
+					staleHandles++;
+				}
+			}
+			handles.pop_back();
+		}
+
+		// Segments emptied by the burst must have been released
+		maxCapacity = std::max(maxCapacity, iterCapacity);
+		if (iterCapacity > (1ull << LifetimeHandle::SegmentBits) && pool->GetAllocator().Capacity() >= iterCapacity) {
+			shrinkFailures++;
+		}
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+	INFO("Lifetime benchmark: %lld allocations in %lld ms (%.1f ns/op); peak pool size %lld, final pool size %lld, %lld failed allocations, %lld stale handles",
+		(int64_t)totalAllocations, (int64_t)ms, totalAllocations ? (ms * 1000000.0 / (totalAllocations * 2)) : 0.0,
+		(int64_t)maxCapacity, (int64_t)pool->GetAllocator().Capacity(), (int64_t)failedAllocations, (int64_t)staleHandles);
+
+	if (shrinkFailures > 0) {
+		OsiError("Lifetime pool didn't shrink after " << shrinkFailures << " of " << numIterations << " bursts were released!");
+	}
+}
+
+// Development-only benchmark for GUID matching in Osiris database queries.
+// Compares the string comparison and cached binary GUID paths of DB:Get() on a synthetic single-column fact list.
+void BenchmarkOsiGuidMatch(std::optional<uint32_t> rows, std::optional<uint32_t> iterations)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("BenchmarkOsiGuidMatch() only supported in developer mode");
+		return;
+	}
+
+	auto numRows = rows.value_or(100000);
+	auto numIterations = iterations.value_or(10);
+	// Number of distinct GUIDs in the fact list; each GUID is repeated numRows / DistinctGuids times
+	constexpr uint32_t DistinctGuids = 100;
+
+	Vector<STDString> strings;
+	std::vector<TypedValue> values(numRows);
+	std::vector<esv::lua::OsiFactGuidCache::Fact> facts(numRows);
+	strings.reserve(numRows);
+
+	for (uint32_t i = 0; i < numRows; i++) {
+		auto key = (uint64_t)(i % DistinctGuids) * 0x9e3779b97f4a7c15ull;
+		char guid[64];
+		sprintf_s(guid, "%08x-%04x-%04x-%04x-%012llx", (uint32_t)(key >> 32), (uint32_t)(key >> 16) & 0xffff,
+			(uint32_t)key & 0xffff, i % DistinctGuids, key & 0xffffffffffffull);
+
+		STDString str;
+		// Mix in name-prefixed, uppercase and malformed GUIDs
+		if (i % 4 == 1) str = "S_Benchmark_Item_";
+		str += guid;
+		if (i % 3 == 2) std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+		if (i % 1000 == 999) str[str.size() - 13] = '_';
+		strings.push_back(str);
+
+		values[i].TypeId = (uint32_t)ValueType::GuidString;
+		values[i].Value.Val.String = strings.back().data();
+		facts[i].Item.Values = &values[i];
+		facts[i].Item.Size = 1;
+	}
+
+	auto query = strings[0];
+	uint64_t stringMatches{ 0 }, guidMatches{ 0 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t iter = 0; iter < numIterations; iter++) {
+		for (uint32_t i = 0; i < numRows; i++) {
+			if (esv::lua::OsiGuidStringsEqual(values[i].Value.Val.String, nullptr, query.c_str(), nullptr)) {
+				stringMatches++;
+			}
+		}
+	}
+	auto stringEnd = std::chrono::high_resolution_clock::now();
+
+	Vector<ValueType> columnTypes{ ValueType::GuidString };
+	esv::lua::OsiFactGuidCache cache(columnTypes);
+	esv::lua::OsiGuidValue queryGuid;
+	esv::lua::ParseOsiGuid(query.c_str(), queryGuid);
+
+	// The first pass populates the cache
+	for (uint32_t iter = 0; iter < numIterations + 1; iter++) {
+		if (iter == 1) {
+			guidMatches = 0;
+		}
+
+		for (uint32_t i = 0; i < numRows; i++) {
+			auto row = cache.GetRow(i, &facts[i]);
+			if (esv::lua::OsiGuidStringsEqual(values[i].Value.Val.String, row, query.c_str(), &queryGuid)) {
+				guidMatches++;
+			}
+		}
+	}
+	auto guidEnd = std::chrono::high_resolution_clock::now();
+
+	auto stringNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stringEnd - start).count();
+	auto guidNs = std::chrono::duration_cast<std::chrono::nanoseconds>(guidEnd - stringEnd).count();
+	auto numCompares = (double)numRows * numIterations;
+
+	INFO("Osiris GUID match benchmark (%d rows, %d iterations): string compare %.2f ns/row, binary compare %.2f ns/row (including cache fill); %lld/%lld matches",
+		numRows, numIterations, stringNs / numCompares, guidNs / (numCompares + numRows),
+		(int64_t)stringMatches, (int64_t)guidMatches);
+
+	if (stringMatches != guidMatches) {
+		OsiError("GUID match results differ between string and binary comparison!");
+	}
+}
+
+// Builds a minimal PE image with .text, .rdata and .data sections of the specified size
+STDString MakeSyntheticModule(std::size_t sectionSize)
+{
+	constexpr std::size_t HeadersSize = 0x400;
+	char const* names[] = { ".text", ".rdata", ".data" };
+	auto numSections = (WORD)std::size(names);
+
+	STDString image;
+	image.resize(HeadersSize + numSections * sectionSize);
+
+	auto dosHdr = reinterpret_cast<IMAGE_DOS_HEADER*>(image.data());
+	dosHdr->e_magic = IMAGE_DOS_SIGNATURE;
+	dosHdr->e_lfanew = sizeof(IMAGE_DOS_HEADER);
+
+	auto ntHdr = reinterpret_cast<IMAGE_NT_HEADERS64*>(image.data() + dosHdr->e_lfanew);
+	ntHdr->Signature = IMAGE_NT_SIGNATURE;
+	ntHdr->FileHeader.Machine = IMAGE_FILE_MACHINE_AMD64;
+	ntHdr->FileHeader.NumberOfSections = numSections;
+	ntHdr->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER64);
+	ntHdr->OptionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR64_MAGIC;
+	ntHdr->OptionalHeader.SizeOfHeaders = (DWORD)HeadersSize;
+
+	auto sectionHdr = IMAGE_FIRST_SECTION(ntHdr);
+	for (WORD i = 0; i < numSections; i++, sectionHdr++) {
+		memcpy(sectionHdr->Name, names[i], strlen(names[i]));
+		sectionHdr->SizeOfRawData = (DWORD)sectionSize;
+		sectionHdr->PointerToRawData = (DWORD)(HeadersSize + i * sectionSize);
+		sectionHdr->VirtualAddress = sectionHdr->PointerToRawData;
+		sectionHdr->Misc.VirtualSize = (DWORD)sectionSize;
+	}
+
+	uint64_t seed = 0x9e3779b97f4a7c15ull;
+	for (auto i = HeadersSize; i < image.size(); i++) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		image[i] = (char)(seed >> 56);
+	}
+
+	return image;
+}
+
+bool HashSyntheticModule(STDString const& image, uint64_t& hash)
+{
+	std::istringstream file(std::string(image.data(), image.size()), std::ios::in | std::ios::binary);
+	hash = 0;
+	return SymbolMapper::HashModuleSections(reinterpret_cast<uint8_t const*>(image.data()), file, hash);
+}
+
+// Checks that a symbol cache written for a module is rejected after one byte of its code or read-only data changes
+bool CheckSymbolCacheKey(STDString const& image, std::size_t sectionSize)
+{
+	constexpr std::size_t HeadersSize = 0x400;
+	uint64_t key;
+	if (!HashSyntheticModule(image, key)) {
+		OsiError("Couldn't hash sections of synthetic module");
+		return false;
+	}
+
+	auto path = (std::filesystem::temp_directory_path() / L"OsiExtenderSymbolCacheTest.bin").wstring();
+	SymbolMappingCache cache;
+	cache.Load(path, key);
+	cache.Set("SyntheticMapping", std::vector<uint32_t>{ 0x10, 0x20 });
+	if (!cache.Save(path)) {
+		OsiError("Couldn't write symbol cache test file");
+		return false;
+	}
+
+	bool ok = true;
+	SymbolMappingCache loaded;
+	if (!loaded.Load(path, key) || loaded.Get("SyntheticMapping") == nullptr) {
+		OsiError("Symbol cache missed for an unchanged module");
+		ok = false;
+	}
+
+	struct Patch
+	{
+		char const* Section;
+		std::size_t Offset;
+		bool ExpectMiss;
+	};
+
+	Patch patches[] = {
+		{ ".text", HeadersSize + sectionSize / 2, true },
+		{ ".rdata", HeadersSize + sectionSize + sectionSize - 1, true },
+		// Writable data isn't part of the key
+		{ ".data", HeadersSize + 2 * sectionSize, false },
+	};
+
+	for (auto const& patch : patches) {
+		auto patched = image;
+		patched[patch.Offset] ^= 0x01;
+
+		uint64_t patchedKey;
+		if (!HashSyntheticModule(patched, patchedKey)) {
+			OsiError("Couldn't hash sections of patched synthetic module");
+			ok = false;
+			continue;
+		}
+
+		bool hit = loaded.Load(path, patchedKey);
+		if (hit == patch.ExpectMiss) {
+			OsiError("Symbol cache " << (hit ? "hit" : "missed") << " after patching one byte of " << patch.Section);
+			ok = false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+	return ok;
+}
+
+// Development-only benchmark for the symbol mapping cache key.
+// Checks that patching a synthetic module invalidates its cache, then measures section hashing throughput.
+void BenchmarkSymbolCacheKey(std::optional<uint32_t> sizeMb, std::optional<uint32_t> iterations)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("BenchmarkSymbolCacheKey() only supported in developer mode");
+		return;
+	}
+
+	auto sectionSize = (std::size_t)sizeMb.value_or(16) * 1024 * 1024;
+	auto numIterations = iterations.value_or(10);
+
+	auto image = MakeSyntheticModule(sectionSize);
+	if (!CheckSymbolCacheKey(image, sectionSize)) {
+		return;
+	}
+
+	uint64_t key{ 0 };
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t iter = 0; iter < numIterations; iter++) {
+		HashSyntheticModule(image, key);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	auto ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+	auto hashedMb = 2 * sectionSize / (1024.0 * 1024.0);
+	INFO("Symbol cache key benchmark (%.1f MB hashed, %d iterations): %.2f ms (%.0f MB/s), key %016llx",
+		hashedMb, numIterations, ms / numIterations, hashedMb * numIterations * 1000.0 / std::max(ms, 0.001), key);
+}
+
+bool CheckStoryPreprocessor()
+{
+	struct TestCase
+	{
+		char const* Input;
+		char const* Expected;
+	};
+
+	static constexpr TestCase cases[] = {
+		{ "A\n/* [OSITOOLS_ONLY]\nB\n*/\nC", "A\nB\n\nC" },
+		{ "A\n// [BEGIN_NO_OSITOOLS]\nB\n// [END_NO_OSITOOLS]\nC", "A\nC" },
+		{ "/* [OSITOOLS_ONLY]\nA\n// [BEGIN_NO_OSITOOLS]\nB\n// [END_NO_OSITOOLS]\nC*/", "A\nC" },
+		// Markers overlapping the end of a tag aren't recognized
+		{ "/* [OSITOOLS_ONLY]// [BEGIN_NO_OSITOOLS]// [END_NO_OSITOOLS]*/", "/ [BEGIN_NO_OSITOOLS]// [END_NO_OSITOOLS]" },
+		{ "/* [OSITOOLS_ONLY]\nA*// [BEGIN_NO_OSITOOLS]\nB\n// [END_NO_OSITOOLS]\nC", "A/ [BEGIN_NO_OSITOOLS]\nB\n// [END_NO_OSITOOLS]\nC" },
+		// Comment end running into a marker
+		{ "/* [OSITOOLS_ONLY]\nA\n*/// [BEGIN_NO_OSITOOLS]\nB\n// [END_NO_OSITOOLS]\nC", "A\nC" },
+		{ "/* [OSITOOLS_ONLY]\nA\n*/// [END_NO_OSITOOLS]\nB", "A\n// [END_NO_OSITOOLS]\nB" },
+		{ "// [BEGIN_NO_OSITOOLS]\nA\n/* [OSITOOLS_ONLY]\nB*/// [END_NO_OSITOOLS]\nC", "C" },
+		{ "/* [OSITOOLS_ONLY]\nA\n// [BEGIN_NO_OSITOOLS]\nB*/// [END_NO_OSITOOLS]\nC", "A\nC" },
+		{ "/* [OSITOOLS_ONLY]\nA*/// [BEGIN_NO_OSITOOLS]\nB\n*/// [END_NO_OSITOOLS]\nC", "AC" },
+		// An end marker sharing its slash with the comment end still closes the block.
+		// The two-pass preprocessor lost the marker when removing the comment end and kept the block.
+		{ "/* [OSITOOLS_ONLY]\n// [BEGIN_NO_OSITOOLS]\n*// [END_NO_OSITOOLS]\n", "" },
+	};
+
+	bool ok = true;
+	STDString output;
+	for (auto const& test : cases) {
+		try {
+			CustomFunctionManager::PreProcessStory(test.Input, output);
+		} catch (std::exception& e) {
+			OsiError("Story preprocessor threw on input '" << test.Input << "': " << e.what());
+			ok = false;
+			continue;
+		}
+
+		if (output != test.Expected) {
+			OsiError("Story preprocessor output mismatch for input '" << test.Input << "': got '" << output << "', expected '" << test.Expected << "'");
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+// Development-only benchmark for the story preprocessor.
+// Checks the output on a few edge cases, then measures preprocessing and cache key hashing of a synthetic
+// goal file containing both preprocessor block types.
+void BenchmarkStoryPreprocessor(std::optional<uint32_t> sizeMb, std::optional<uint32_t> iterations)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("BenchmarkStoryPreprocessor() only supported in developer mode");
+		return;
+	}
+
+	if (!CheckStoryPreprocessor()) {
+		return;
+	}
+
+	auto size = (std::size_t)sizeMb.value_or(16) * 1024 * 1024;
+	auto numIterations = iterations.value_or(10);
+
+	STDString story;
+	story.reserve(size + 0x1000);
+	for (uint32_t i = 0; story.size() < size; i++) {
+		char rule[512];
+		sprintf_s(rule, "IF\r\nDB_Benchmark_Trigger(%d, _Char)\r\nTHEN\r\nDB_Benchmark_Result(%d, _Char);\r\n", i, i);
+		story += rule;
+
+		if (i % 16 == 3) {
+			story += "/* [OSITOOLS_ONLY]\r\nNRD_DebugLog(\"Benchmark\");\r\n*/\r\n";
+		} else if (i % 16 == 11) {
+			story += "// [BEGIN_NO_OSITOOLS]\r\nDB_Benchmark_NoExtender(1);\r\n// [END_NO_OSITOOLS]\r\n";
+		}
+
+		story += "\r\n";
+	}
+
+	STDString output;
+	uint64_t hash{ 0 };
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t iter = 0; iter < numIterations; iter++) {
+		CustomFunctionManager::PreProcessStory(story, output);
+	}
+	auto preprocessEnd = std::chrono::high_resolution_clock::now();
+
+	for (uint32_t iter = 0; iter < numIterations; iter++) {
+		hash ^= CustomFunctionManager::HashStory(story);
+	}
+	auto hashEnd = std::chrono::high_resolution_clock::now();
+
+	auto preprocessMs = std::chrono::duration_cast<std::chrono::microseconds>(preprocessEnd - start).count() / 1000.0;
+	auto hashMs = std::chrono::duration_cast<std::chrono::microseconds>(hashEnd - preprocessEnd).count() / 1000.0;
+	auto storyMb = story.size() / (1024.0 * 1024.0);
+
+	INFO("Story preprocessor benchmark (%.1f MB, %d iterations): preprocess %.2f ms (%.0f MB/s), hash %.2f ms (%.0f MB/s); output %.1f MB, hash %016llx",
+		storyMb, numIterations, preprocessMs / numIterations, storyMb * numIterations * 1000.0 / std::max(preprocessMs, 0.001),
+		hashMs / numIterations, storyMb * numIterations * 1000.0 / std::max(hashMs, 0.001),
+		output.size() / (1024.0 * 1024.0), hash);
+}
+
+/// <summary>
+/// Returns the counters of the incremental garbage collection scheduler of the current Lua state.
+/// </summary>
+UserReturn GetGCStats(lua_State* L)
+{
+	auto const& gc = State::FromLua(L)->GetGCScheduler();
+	auto const& stats = gc.GetStats();
+
+	lua_newtable(L);
+	setfield(L, "Budget", gc.GetBudget());
+	setfield(L, "Ticks", stats.Ticks);
+	setfield(L, "Steps", stats.Steps);
+	setfield(L, "SkippedTicks", stats.SkippedTicks);
+	setfield(L, "BudgetExhaustedTicks", stats.BudgetExhaustedTicks);
+	setfield(L, "CompletedCycles", stats.CompletedCycles);
+	setfield(L, "FullCollections", stats.FullCollections);
+	setfield(L, "TotalTime", stats.TotalTimeUs);
+	setfield(L, "FullCollectionTime", stats.FullCollectionTimeUs);
+	setfield(L, "LastTickTime", stats.LastTickTimeUs);
+	setfield(L, "MaxTickTime", stats.MaxTickTimeUs);
+	setfield(L, "LastStepSize", stats.LastStepSizeKb);
+	setfield(L, "HeapSize", stats.HeapSizeKb);
+	setfield(L, "AllocationRate", (double)stats.AllocationRateKbPerSec);
+	setfield(L, "StepCost", (double)stats.StepCostUsPerKb);
+	setfield(L, "FrameTime", (double)stats.FrameTimeUs);
+	return 1;
+}
+
+/// <summary>
+/// Sets the maximum time (in microseconds) spent on incremental garbage collection per tick.
+/// </summary>
+void SetGCBudget(lua_State* L, uint32_t budget)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("SetGCBudget() only supported in developer mode");
+		return;
+	}
+
+	State::FromLua(L)->GetGCScheduler().SetBudget(budget);
+}
+
+/// <summary>
+/// Performs a full garbage collection cycle and records it in the GC scheduler counters.
+/// </summary>
+void FullGC(lua_State* L)
+{
+	if (!gExtender->GetConfig().DeveloperMode) {
+		OsiError("FullGC() only supported in developer mode");
+		return;
+	}
+
+	State::FromLua(L)->GetGCScheduler().FullCollect(L);
+}
+
+void PushLatencyStats(lua_State* L, LatencyHistogram const& stats)
+{
+	// Latencies are recorded in nanoseconds, but reported in microseconds
+	setfield(L, "Count", stats.Count());
+	setfield(L, "Total", stats.Total() / 1000.0);
+	setfield(L, "Mean", stats.Mean() / 1000.0);
+	setfield(L, "P50", stats.Percentile(50.0) / 1000.0);
+	setfield(L, "P90", stats.Percentile(90.0) / 1000.0);
+	setfield(L, "P99", stats.Percentile(99.0) / 1000.0);
+	setfield(L, "Max", stats.Max() / 1000.0);
+}
+
+/// <summary>
+/// Enables or disables latency tracking for engine events and their handlers.
+/// </summary>
+void SetEventProfiling(lua_State* L, bool enabled)
+{
+	State::FromLua(L)->SetEventProfiling(enabled);
+}
+
+/// <summary>
+/// Clears the event latency statistics collected so far.
+/// </summary>
+void ResetEventStats(lua_State* L)
+{
+	for (auto const& event : State::FromLua(L)->GetEvents()) {
+		event.second->ResetStats();
+	}
+}
+
+/// <summary>
+/// Returns event and handler latency statistics (in microseconds) collected while event profiling was enabled.
+/// Handlers are identified by the location where the handler function was defined.
+/// </summary>
+UserReturn GetEventStats(lua_State* L)
+{
+	lua_newtable(L);
+	for (auto const& event : State::FromLua(L)->GetEvents()) {
+		auto latency = event.second->GetLatencyStats();
+		if (latency == nullptr || latency->Count() == 0) continue;
+
+		push(L, event.first);
+		lua_newtable(L);
+		PushLatencyStats(L, *latency);
+
+		lua_newtable(L);
+		int index = 1;
+		for (auto const& handler : event.second->GetHandlerStats()) {
+			if (handler.second->Latency.Count() == 0) continue;
+
+			push(L, index++);
+			lua_newtable(L);
+			setfield(L, "Source", handler.second->Source);
+			setfield(L, "Mod", handler.second->Mod);
+			PushLatencyStats(L, handler.second->Latency);
+			lua_settable(L, -3);
+		}
+		lua_setfield(L, -2, "Handlers");
+
+		lua_settable(L, -3);
+	}
+
+	return 1;
+}
+
+/// <summary>
+/// Prints the handlers with the highest total execution time to the console.
+/// </summary>
+/// <param name="limit">Number of handlers to print (default 20)</param>
+void DumpEventStats(lua_State* L, std::optional<uint32_t> limit)
+{
+	std::vector<std::pair<FixedString, EventHandlerStats const*>> handlers;
+	for (auto const& event : State::FromLua(L)->GetEvents()) {
+		for (auto const& handler : event.second->GetHandlerStats()) {
+			if (handler.second->Latency.Count() > 0) {
+				handlers.push_back(std::make_pair(event.second->GetName(), handler.second.get()));
+			}
+		}
+	}
+
+	std::sort(handlers.begin(), handlers.end(), [](auto const& a, auto const& b) {
+		return a.second->Latency.Total() > b.second->Latency.Total();
+	});
+
+	INFO(" === EVENT HANDLER LATENCIES (us) === ");
+	auto numHandlers = std::min(handlers.size(), (std::size_t)limit.value_or(20));
+	for (std::size_t i = 0; i < numHandlers; i++) {
+		auto const& stats = handlers[i].second->Latency;
+		INFO("%s [%s] %s: %lld calls, total %.1f, mean %.1f, p50 %.1f, p99 %.1f, max %.1f",
+			handlers[i].first.GetStringOrDefault(), handlers[i].second->Mod.c_str(), handlers[i].second->Source.c_str(),
+			(int64_t)stats.Count(), stats.Total() / 1000.0, stats.Mean() / 1000.0, stats.Percentile(50.0) / 1000.0,
+			stats.Percentile(99.0) / 1000.0, stats.Max() / 1000.0);
+	}
+}
+
+/// <summary>
+/// Starts the sampling profiler on the current Lua state.
+/// </summary>
+/// <param name="interval">Sampling interval in microseconds (default 1000)</param>
+/// <param name="maxStacks">Maximum number of distinct call stacks to keep (default 20000)</param>
+bool StartProfiler(lua_State* L, std::optional<uint32_t> interval, std::optional<uint32_t> maxStacks)
+{
+	auto& profiler = State::FromLua(L)->GetProfiler();
+	profiler.Reset();
+	return profiler.Start(L, interval.value_or(SamplingProfiler::DefaultIntervalUs),
+		maxStacks.value_or((uint32_t)SamplingProfiler::DefaultMaxStacks));
+}
+
+/// <summary>
+/// Stops the sampling profiler and optionally writes the collected stacks to a file in the folded stack format.
+/// </summary>
+/// <param name="path">Output path, relative to the script extender storage directory</param>
+bool StopProfiler(lua_State* L, std::optional<STDString> path)
+{
+	auto& profiler = State::FromLua(L)->GetProfiler();
+	profiler.Stop(L);
+	INFO("Profiler stopped: %lld samples, %lld distinct stacks, %lld dropped samples",
+		(int64_t)profiler.NumSamples(), (int64_t)profiler.NumStacks(), (int64_t)profiler.NumDroppedSamples());
+
+	if (path) {
+		return profiler.SaveFoldedStacks(*path);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Returns the stacks collected by the sampling profiler in the folded stack format.
+/// </summary>
+STDString GetProfilerStacks(lua_State* L)
+{
+	return State::FromLua(L)->GetProfiler().GetFoldedStacks();
 }
 
 void DumpNetworking()
@@ -308,6 +903,20 @@ void RegisterDebugLib()
 	MODULE_FUNCTION(DumpStack)
 	MODULE_FUNCTION(DumpNetworking)
 	MODULE_FUNCTION(DebugDumpLifetimes)
+	MODULE_FUNCTION(BenchmarkLifetimes)
+	MODULE_FUNCTION(BenchmarkOsiGuidMatch)
+	MODULE_FUNCTION(BenchmarkStoryPreprocessor)
+	MODULE_FUNCTION(BenchmarkSymbolCacheKey)
+	MODULE_FUNCTION(GetGCStats)
+	MODULE_FUNCTION(SetGCBudget)
+	MODULE_FUNCTION(FullGC)
+	MODULE_FUNCTION(SetEventProfiling)
+	MODULE_FUNCTION(ResetEventStats)
+	MODULE_FUNCTION(GetEventStats)
+	MODULE_FUNCTION(DumpEventStats)
+	MODULE_FUNCTION(StartProfiler)
+	MODULE_FUNCTION(StopProfiler)
+	MODULE_FUNCTION(GetProfilerStacks)
 	MODULE_FUNCTION(GenerateIdeHelpers)
 	MODULE_NAMED_FUNCTION("DebugBreak", LuaDebugBreak)
 	MODULE_FUNCTION(IsDeveloperMode)
@@ -11,6 +11,7 @@
 #include <Lua/Shared/Proxies/LuaEnumValue.inl>
 #include <Lua/Shared/Proxies/LuaBitfieldValue.inl>
 #include <Lua/Shared/Proxies/LuaUserVariableHolder.inl>
+#include <Lua/Shared/Proxies/LuaMathValue.inl>
 
 BEGIN_SE()
 
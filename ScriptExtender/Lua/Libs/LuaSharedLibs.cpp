@@ -89,6 +89,8 @@ void RegisterSharedMetatables(lua_State* L)
 	BitfieldValueMetatable::RegisterMetatable(L);
 	UserVariableHolderMetatable::RegisterMetatable(L);
 	ModVariableHolderMetatable::RegisterMetatable(L);
+	MathValue::RegisterMetatable(L);
+	SubscribableEventProxy::RegisterMetatable(L);
 	InitObjectProxyPropertyMaps();
 	RegisterEntityProxy(L);
 	StatsExtraDataProxy::RegisterMetatable(L);
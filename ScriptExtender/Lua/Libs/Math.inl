@@ -12,6 +12,108 @@
 /// <lua_module>Math</lua_module>
 BEGIN_NS(lua::math)
 
+// Returns a native math value if any of the arguments were native values;
+// otherwise the result is pushed the same way as property values.
+template <class T>
+void PushResult(lua_State* L, T const& v)
+{
+	if constexpr (requires { MathValue::Make(L, v); }) {
+		auto top = std::min(lua_gettop(L), 2);
+		for (auto i = 1; i <= top; i++) {
+			if (MathValue::AsUserData(L, i) != nullptr) {
+				MathValue::Make(L, v);
+				return;
+			}
+		}
+	}
+
+	push(L, v);
+}
+
+template <unsigned N>
+int MakeNativeValue(lua_State* L)
+{
+	float values[N];
+	auto numArgs = lua_gettop(L);
+	if (numArgs == 1 && lua_type(L, 1) != LUA_TNUMBER) {
+		switch (lua_type(L, 1)) {
+		case LUA_TTABLE:
+			for (unsigned i = 0; i < N; i++) {
+				lua_rawgeti(L, 1, i + 1);
+				values[i] = (float)luaL_checknumber(L, -1);
+				lua_pop(L, 1);
+			}
+			break;
+
+		case LUA_TUSERDATA:
+		{
+			auto other = MathValue::CheckUserData(L, 1);
+			if (other->Arity() != N) {
+				return luaL_error(L, "Expected a %d-element value, got a %d-element value", N, other->Arity());
+			}
+
+			std::copy(other->Values(), other->Values() + N, values);
+			break;
+		}
+
+		default:
+			return luaL_error(L, "Expected a table or numbers, got '%s'", lua_typename(L, lua_type(L, 1)));
+		}
+	} else if (numArgs == 0) {
+		std::fill(values, values + N, 0.0f);
+	} else if (numArgs == N) {
+		for (unsigned i = 0; i < N; i++) {
+			values[i] = (float)luaL_checknumber(L, i + 1);
+		}
+	} else {
+		return luaL_error(L, "Expected %d components, got %d", N, numArgs);
+	}
+
+	MathValue::Make(L, values, N);
+	return 1;
+}
+
+/// <summary>
+/// Creates a native 2-component vector. Accepts either 2 numbers, a table or another vector; zero vector if no arguments are passed.
+/// Native values support indexing with `[1..n]` and `.x/.y/.z/.w` and arithmetic operators, and can be passed to any function that expects a vector table.
+/// </summary>
+UserReturn Vec2(lua_State* L)
+{
+	return MakeNativeValue<2>(L);
+}
+
+/// <summary>
+/// Creates a native 3-component vector. Accepts either 3 numbers, a table or another vector; zero vector if no arguments are passed.
+/// </summary>
+UserReturn Vec3(lua_State* L)
+{
+	return MakeNativeValue<3>(L);
+}
+
+/// <summary>
+/// Creates a native 4-component vector. Accepts either 4 numbers, a table or another vector; zero vector if no arguments are passed.
+/// </summary>
+UserReturn Vec4(lua_State* L)
+{
+	return MakeNativeValue<4>(L);
+}
+
+/// <summary>
+/// Creates a native 3 * 3 matrix. Accepts either 9 numbers, a table or another matrix; zero matrix if no arguments are passed.
+/// </summary>
+UserReturn Mat3(lua_State* L)
+{
+	return MakeNativeValue<9>(L);
+}
+
+/// <summary>
+/// Creates a native 4 * 4 matrix. Accepts either 16 numbers, a table or another matrix; zero matrix if no arguments are passed.
+/// </summary>
+UserReturn Mat4(lua_State* L)
+{
+	return MakeNativeValue<16>(L);
+}
+
 template <class T>
 struct TryOpOrFail
 {
@@ -101,6 +203,12 @@ __forceinline void CallPolymorphicFunc(lua_State* L, MathParam const& a)
 		}
 		break;
 
+	case 2: 
+		if constexpr (Vector) {
+			handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.vec2);
+		}
+		break;
+
 	case 3: 
 		if constexpr (Vector) {
 			handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.vec3);
@@ -140,6 +248,7 @@ __forceinline void CallPolymorphicFunc(lua_State* L, MathParam const& a, MathPar
 		if constexpr (Scalar) {
 			switch (b.Arity) {
 			case 1: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.f, b.f); break;
+			case 2: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.f, b.vec2); break;
 			case 3: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.f, b.vec3); break;
 			case 4: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.f, b.vec4); break;
 			case 9: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.f, b.mat3); break;
@@ -149,6 +258,16 @@ __forceinline void CallPolymorphicFunc(lua_State* L, MathParam const& a, MathPar
 		break;
 	}
 
+	case 2: {
+		if constexpr (Vector) {
+			switch (b.Arity) {
+			case 1: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.vec2, b.f); break;
+			case 2: handled = TryCallPolymorphicFunc<Fun, InPlace>(L, a.vec2, b.vec2); break;
+			}
+		}
+		break;
+	}
+
 	case 3: {
 		if constexpr (Vector) {
 			switch (b.Arity) {
@@ -231,7 +350,7 @@ struct AddOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(a + b), void())
 	{
-		push(L, a + b);
+		PushResult(L, a + b);
 	}
 
 	template <class T1, class T2>
@@ -252,7 +371,7 @@ struct SubtractOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(a + b), void())
 	{
-		push(L, a - b);
+		PushResult(L, a - b);
 	}
 
 	template <class T1, class T2>
@@ -273,7 +392,7 @@ struct MultiplyOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(a * b), void())
 	{
-		push(L, a * b);
+		PushResult(L, a * b);
 	}
 
 	template <class T1, class T2>
@@ -294,7 +413,7 @@ struct DivideOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(a / b), void())
 	{
-		push(L, a / b);
+		PushResult(L, a / b);
 	}
 
 	template <class T1, class T2>
@@ -315,7 +434,7 @@ struct ReflectOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(glm::reflect(a, b)), void())
 	{
-		push(L, glm::reflect(a, b));
+		PushResult(L, glm::reflect(a, b));
 	}
 
 	template <class T1, class T2>
@@ -339,7 +458,7 @@ struct AngleOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(glm::angle(a, b)), void())
 	{
-		push(L, glm::angle(a, b));
+		PushResult(L, glm::angle(a, b));
 	}
 
 	template <class T1, class T2>
@@ -369,7 +488,7 @@ UserReturn Cross(lua_State* L, glm::vec3 const& x, glm::vec3 const& y)
 		assign(L, 3, glm::cross(x, y));
 		return 0;
 	} else {
-		push(L, glm::cross(x, y));
+		PushResult(L, glm::cross(x, y));
 		return 1;
 	}
 }
@@ -398,7 +517,7 @@ struct LengthOp
 	template <class T1>
 	static __forceinline auto Do(lua_State* L, T1 const& a) -> decltype((void)(glm::length(a)), void())
 	{
-		push(L, glm::length(a));
+		PushResult(L, glm::length(a));
 	}
 };
 
@@ -416,7 +535,7 @@ struct NormalizeOp
 	template <class T1>
 	static __forceinline auto Do(lua_State* L, T1 const& a) -> decltype((void)(glm::normalize(a)), void())
 	{
-		push(L, glm::normalize(a));
+		PushResult(L, glm::normalize(a));
 	}
 
 	template <class T1>
@@ -440,7 +559,7 @@ struct DeterminantOp
 	template <class T1>
 	static __forceinline auto Do(lua_State* L, T1 const& a) -> decltype((void)(glm::determinant(a)), void())
 	{
-		push(L, glm::determinant(a));
+		PushResult(L, glm::determinant(a));
 	}
 };
 
@@ -458,7 +577,7 @@ struct InverseOp
 	template <class T1>
 	static __forceinline auto Do(lua_State* L, T1 const& a) -> decltype((void)(glm::inverse(a)), void())
 	{
-		push(L, glm::inverse(a));
+		PushResult(L, glm::inverse(a));
 	}
 
 	template <class T1>
@@ -482,7 +601,7 @@ struct TransposeOp
 	template <class T1>
 	static __forceinline auto Do(lua_State* L, T1 const& a) -> decltype((void)(glm::transpose(a)), void())
 	{
-		push(L, glm::transpose(a));
+		PushResult(L, glm::transpose(a));
 	}
 
 	template <class T1>
@@ -503,10 +622,11 @@ UserReturn Transpose(lua_State* L, MathParam const& a)
 
 struct OuterProductOp
 {
+	// vec2 * vec2 yields a 2x2 matrix, which has no Lua representation
 	template <class T1, class T2>
-	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(glm::outerProduct(a, b)), void())
+	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)assign(L, 3, glm::outerProduct(a, b)), void())
 	{
-		push(L, glm::outerProduct(a, b));
+		PushResult(L, glm::outerProduct(a, b));
 	}
 
 	template <class T1, class T2>
@@ -714,7 +834,7 @@ struct PerpendicularOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(glm::perp(a, b)), void())
 	{
-		push(L, glm::perp(a, b));
+		PushResult(L, glm::perp(a, b));
 	}
 
 	template <class T1, class T2>
@@ -738,7 +858,7 @@ struct ProjectOp
 	template <class T1, class T2>
 	static __forceinline auto Do(lua_State* L, T1 const& a, T2 const& b) -> decltype((void)(glm::proj(a, b)), void())
 	{
-		push(L, glm::proj(a, b));
+		PushResult(L, glm::proj(a, b));
 	}
 
 	template <class T1, class T2>
@@ -859,6 +979,12 @@ void RegisterMathLib()
 {
 	DECLARE_MODULE(Math, Both)
 	BEGIN_MODULE()
+	MODULE_FUNCTION(Vec2)
+	MODULE_FUNCTION(Vec3)
+	MODULE_FUNCTION(Vec4)
+	MODULE_FUNCTION(Mat3)
+	MODULE_FUNCTION(Mat4)
+
 	MODULE_FUNCTION(Add)
 	MODULE_FUNCTION(Sub)
 	MODULE_FUNCTION(Mul)
@@ -166,6 +166,33 @@ void NewEvent(lua_State * L)
 	functionMgr.RegisterDynamic(std::move(customEvt));
 }
 
+template <class T>
+void PushArgumentPoolStats(lua_State* L, char const* name, OsiArgumentPool<T> const& pool)
+{
+	auto const& stats = pool.GetStats();
+	lua_newtable(L);
+	setfield(L, "Chunks", stats.Chunks);
+	setfield(L, "Capacity", stats.Capacity);
+	setfield(L, "InUse", stats.InUse);
+	setfield(L, "HighWaterMark", stats.HighWaterMark);
+	setfield(L, "Allocations", stats.Allocations);
+	lua_setfield(L, -2, name);
+}
+
+/// <summary>
+/// Returns the usage counters of the argument pools used when calling Osiris from Lua.
+/// </summary>
+UserReturn GetArgumentPoolStats(lua_State* L)
+{
+	auto& osiris = ServerState::FromLua(L)->Osiris();
+	lua_newtable(L);
+	PushArgumentPoolStats(L, "ArgumentDesc", osiris.GetArgumentDescPool());
+	PushArgumentPoolStats(L, "TypedValue", osiris.GetTypedValuePool());
+	PushArgumentPoolStats(L, "TypedValueNode", osiris.GetTypedValueNodePool());
+	PushArgumentPoolStats(L, "TupleNode", osiris.GetTupleNodePool());
+	return 1;
+}
+
 void RegisterOsirisLib()
 {
 	DECLARE_MODULE(Osiris, Server)
@@ -175,6 +202,7 @@ void RegisterOsirisLib()
 	MODULE_FUNCTION(NewCall)
 	MODULE_FUNCTION(NewQuery)
 	MODULE_FUNCTION(NewEvent)
+	MODULE_FUNCTION(GetArgumentPoolStats)
 	END_MODULE()
 }
 
@@ -106,6 +106,171 @@ ObjectSet<FixedString> GetAllTypes()
 	return types;
 }
 
+struct SnapshotContext
+{
+	// Each nesting level recurses on the C stack and keeps a few values on the Lua stack
+	static constexpr int MaxSnapshotDepth = 32;
+	static constexpr int StackSlotsPerLevel = 6;
+
+	std::unordered_set<FixedString> Fields;
+	bool FilterFields{ false };
+	int MaxDepth{ 0 };
+
+	inline bool IncludeField(FixedString const& name, int depth) const
+	{
+		return depth > 0 || !FilterFields || Fields.find(name) != Fields.end();
+	}
+};
+
+void SnapshotValue(lua_State* L, SnapshotContext const& ctx, int depth);
+
+void SnapshotObjectProxy(lua_State* L, ObjectProxy2* object, SnapshotContext const& ctx, int depth)
+{
+	if (!object->IsAlive(L)) {
+		luaL_error(L, "Attempted to snapshot object of type '%s' whose lifetime has expired", object->GetImpl()->GetTypeName().GetString());
+	}
+
+	auto impl = object->GetImpl();
+	lua_newtable(L);
+	FixedString key;
+	while (impl->Next(L, key) == 2) {
+		key = get<FixedString>(L, -2);
+		if (ctx.IncludeField(key, depth)) {
+			SnapshotValue(L, ctx, depth + 1);
+			lua_rawset(L, -3);
+		} else {
+			lua_pop(L, 2);
+		}
+	}
+}
+
+void SnapshotCppObject(lua_State* L, CppObjectMetadata& meta, SnapshotContext const& ctx, int depth)
+{
+	auto pm = gExtender->GetPropertyMapManager().GetPropertyMap(meta.PropertyMapTag);
+	lua_createtable(L, 0, (int)pm->Properties.size());
+	for (auto const& prop : pm->Properties) {
+		if (!ctx.IncludeField(prop.Name, depth)) {
+			continue;
+		}
+
+		push(L, prop.Name);
+		if (prop.Get(L, meta.Lifetime, meta.Ptr, prop.Offset, prop.Flag) == PropertyOperationResult::Success) {
+			SnapshotValue(L, ctx, depth + 1);
+			lua_rawset(L, -3);
+		} else {
+			lua_pop(L, 1);
+		}
+	}
+}
+
+void SnapshotArray(lua_State* L, CppObjectMetadata& meta, SnapshotContext const& ctx, int depth)
+{
+	auto impl = gExtender->GetPropertyMapManager().GetArrayProxy(meta.PropertyMapTag);
+	auto length = impl->Length(meta);
+	lua_createtable(L, (int)length, 0);
+	for (unsigned i = 1; i <= length; i++) {
+		if (impl->GetElement(L, meta, i)) {
+			SnapshotValue(L, ctx, depth + 1);
+			lua_rawseti(L, -2, i);
+		}
+	}
+}
+
+void SnapshotMap(lua_State* L, CppObjectMetadata& meta, SnapshotContext const& ctx, int depth)
+{
+	auto impl = gExtender->GetPropertyMapManager().GetMapProxy(meta.PropertyMapTag);
+	lua_createtable(L, 0, (int)impl->Length(meta));
+	push(L, nullptr);
+	while (impl->Next(L, meta, lua_absindex(L, -1)) == 2) {
+		// Stack: table, previous key, key, value
+		SnapshotValue(L, ctx, depth + 1);
+		lua_pushvalue(L, -2);
+		lua_insert(L, -2);
+		lua_rawset(L, -5);
+		lua_remove(L, -2);
+	}
+
+	lua_pop(L, 1);
+}
+
+// Replaces the proxy object on the top of the stack with a plain table containing its properties.
+// Non-proxy values and objects nested deeper than the requested depth are left as-is.
+void SnapshotValue(lua_State* L, SnapshotContext const& ctx, int depth)
+{
+	if (depth > ctx.MaxDepth) {
+		return;
+	}
+
+	luaL_checkstack(L, SnapshotContext::StackSlotsPerLevel, "snapshot too deep");
+	auto index = lua_absindex(L, -1);
+	switch (lua_type(L, index)) {
+	case LUA_TUSERDATA:
+	{
+		auto object = Userdata<ObjectProxy2>::AsUserData(L, index);
+		if (object) {
+			SnapshotObjectProxy(L, object, ctx, depth);
+			lua_replace(L, index);
+		}
+		break;
+	}
+
+	case LUA_TLIGHTCPPOBJECT:
+	case LUA_TCPPOBJECT:
+	{
+		CppObjectMetadata meta;
+		lua_get_cppobject(L, index, meta);
+		if (meta.MetatableTag != MetatableTag::ObjectProxyByRef
+			&& meta.MetatableTag != MetatableTag::ArrayProxy
+			&& meta.MetatableTag != MetatableTag::MapProxy) {
+			break;
+		}
+
+		if (!meta.Lifetime.IsAlive(L)) {
+			luaL_error(L, "Attempted to snapshot object whose lifetime has expired");
+		}
+
+		switch (meta.MetatableTag) {
+		case MetatableTag::ObjectProxyByRef: SnapshotCppObject(L, meta, ctx, depth); break;
+		case MetatableTag::ArrayProxy: SnapshotArray(L, meta, ctx, depth); break;
+		case MetatableTag::MapProxy: SnapshotMap(L, meta, ctx, depth); break;
+		}
+
+		lua_replace(L, index);
+		break;
+	}
+	}
+}
+
+/// <summary>
+/// Copies the properties of an object into a plain Lua table in a single call.
+/// Nested objects, arrays and maps are copied up to the specified depth; deeper objects are returned as-is.
+/// </summary>
+/// <param name="object">Object to copy</param>
+/// <param name="fields">Optional list of top-level properties to copy; copies all properties if `nil`</param>
+/// <param name="depth">Number of nested object levels to copy (at most 32); default: 0</param>
+UserReturn Snapshot(lua_State* L)
+{
+	StackCheck _(L, 1);
+	SnapshotContext ctx;
+	if (lua_type(L, 2) == LUA_TTABLE) {
+		ctx.FilterFields = true;
+		for (auto idx : iterate(L, 2)) {
+			ctx.Fields.insert(get<FixedString>(L, idx));
+		}
+	} else if (lua_type(L, 2) != LUA_TNIL && lua_type(L, 2) != LUA_TNONE) {
+		luaL_error(L, "Argument 2: Expected a table or nil, got '%s'", lua_typename(L, lua_type(L, 2)));
+	}
+
+	if (lua_type(L, 3) != LUA_TNIL && lua_type(L, 3) != LUA_TNONE) {
+		auto depth = luaL_checkinteger(L, 3);
+		ctx.MaxDepth = (int)std::clamp<lua_Integer>(depth, 0, SnapshotContext::MaxSnapshotDepth);
+	}
+
+	lua_pushvalue(L, 1);
+	SnapshotValue(L, ctx, 0);
+	return 1;
+}
+
 void RegisterEnumeration(lua_State* L, EnumInfoStore<EnumUnderlyingType> const& ty)
 {
 	lua_newtable(L);
@@ -163,6 +328,7 @@ void RegisterTypesLib()
 	MODULE_FUNCTION(GetObjectType)
 	MODULE_FUNCTION(GetTypeInfo)
 	MODULE_FUNCTION(GetAllTypes)
+	MODULE_FUNCTION(Snapshot)
 	END_MODULE()
 }
 
@@ -26,25 +26,24 @@ void OsirisCallbackManager::Subscribe(STDString const& name, uint32_t arity, Osi
 	if (storyLoaded_) {
 		HookOsiris();
 		RegisterNodeHandler(it->first, it->second);
+		RebuildNodeHandlers();
 	}
 }
 
-void OsirisCallbackManager::RunHandlers(uint64_t nodeRef, TuplePtrLL* tuple) const
+void OsirisCallbackManager::RunHandlers(uint64_t trigger, TuplePtrLL* tuple) const
 {
-	if (merging_) {
-		return;
-	}
-
-	auto it = nodeSubscriberRefs_.equal_range(nodeRef);
-	if (it.first == nodeSubscriberRefs_.end()) {
+	if (merging_ || !HasHandlers(trigger)) {
 		return;
 	}
 
 	LuaServerPin lua(state_);
 	if (lua) {
-		std::for_each(it.first, it.second, [&lua, this, tuple](std::pair<uint64_t, std::size_t> handler) {
-			RunHandler(lua.Get(), subscribers_[handler.second], tuple);
-		});
+		// Handlers may subscribe to new events, so the tables are re-read after each call.
+		// New handlers of the same trigger are always appended to the end of its range.
+		for (uint32_t i = 0; i < nodeHandlers_[trigger].Count; i++) {
+			auto handlerId = nodeHandlerIds_[nodeHandlers_[trigger].First + i];
+			RunHandler(lua.Get(), subscribers_[handlerId], tuple);
+		}
 	}
 }
 
@@ -94,18 +93,18 @@ void OsirisCallbackManager::RunHandler(ServerState& lua, RegistryEntry const& fu
 	}
 }
 
-void OsirisCallbackManager::RunHandlers(uint64_t nodeRef, OsiArgumentDesc* args) const
+void OsirisCallbackManager::RunHandlers(uint64_t trigger, OsiArgumentDesc* args) const
 {
-	auto it = nodeSubscriberRefs_.equal_range(nodeRef);
-	if (it.first == nodeSubscriberRefs_.end()) {
+	if (!HasHandlers(trigger)) {
 		return;
 	}
 
 	LuaServerPin lua(state_);
 	if (lua) {
-		std::for_each(it.first, it.second, [&lua, this, args](std::pair<uint64_t, std::size_t> handler) {
-			RunHandler(lua.Get(), subscribers_[handler.second], args);
-		});
+		for (uint32_t i = 0; i < nodeHandlers_[trigger].Count; i++) {
+			auto handlerId = nodeHandlerIds_[nodeHandlers_[trigger].First + i];
+			RunHandler(lua.Get(), subscribers_[handlerId], args);
+		}
 	}
 }
 
@@ -160,6 +159,8 @@ void OsirisCallbackManager::StoryLoaded()
 	for (auto const& it : nameSubscriberRefs_) {
 		RegisterNodeHandler(it.first, it.second);
 	}
+
+	RebuildNodeHandlers();
 }
 
 void OsirisCallbackManager::StorySetMerging(bool isMerging)
@@ -195,15 +196,42 @@ void OsirisCallbackManager::RegisterNodeHandler(OsirisHookSignature const& sig,
 		return;
 	}
 
-	uint64_t nodeRef = func->Node.Id;
+	uint32_t flags{ 0 };
 	if (sig.type == OsirisHookSignature::AfterTrigger || sig.type == OsirisHookSignature::AfterDeleteTrigger) {
-		nodeRef |= AfterTriggerNodeRef;
+		flags |= AfterTrigger;
 	}
 	if (sig.type == OsirisHookSignature::BeforeDeleteTrigger || sig.type == OsirisHookSignature::AfterDeleteTrigger) {
-		nodeRef |= DeleteTriggerNodeRef;
+		flags |= DeleteTrigger;
 	}
 
-	nodeSubscriberRefs_.insert(std::make_pair(nodeRef, handlerId));
+	nodeSubscriberRefs_.push_back(std::make_pair(GetTrigger(func->Node.Id, flags), handlerId));
+}
+
+void OsirisCallbackManager::RebuildNodeHandlers()
+{
+	// Sorting by (trigger, handler ID) keeps the handlers of each trigger in subscription order
+	std::sort(nodeSubscriberRefs_.begin(), nodeSubscriberRefs_.end());
+
+	nodeTriggerBits_.clear();
+	nodeHandlers_.clear();
+	nodeHandlerIds_.clear();
+	if (nodeSubscriberRefs_.empty()) return;
+
+	auto numTriggers = nodeSubscriberRefs_.back().first + 1;
+	nodeTriggerBits_.resize((numTriggers + 63) / 64, 0);
+	nodeHandlers_.resize(numTriggers);
+	nodeHandlerIds_.reserve(nodeSubscriberRefs_.size());
+
+	for (auto const& ref : nodeSubscriberRefs_) {
+		auto& range = nodeHandlers_[ref.first];
+		if (range.Count == 0) {
+			range.First = (uint32_t)nodeHandlerIds_.size();
+			nodeTriggerBits_[ref.first >> 6] |= 1ull << (ref.first & 63);
+		}
+
+		nodeHandlerIds_.push_back(ref.second);
+		range.Count++;
+	}
 }
 
 void OsirisCallbackManager::HookOsiris()
@@ -221,36 +249,722 @@ void OsirisCallbackManager::HookOsiris()
 
 void OsirisCallbackManager::InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted)
 {
-	uint64_t nodeRef = node->Id;
-	if (deleted) {
-		nodeRef |= DeleteTriggerNodeRef;
+	RunHandlers(GetTrigger(node->Id, deleted ? DeleteTrigger : 0), tuple);
+}
+
+void OsirisCallbackManager::InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted)
+{
+	RunHandlers(GetTrigger(node->Id, AfterTrigger | (deleted ? DeleteTrigger : 0)), tuple);
+}
+
+void OsirisCallbackManager::CallQueryPreHook(Node* node, OsiArgumentDesc* args)
+{
+	RunHandlers(GetTrigger(node->Id, 0), args);
+}
+
+void OsirisCallbackManager::CallQueryPostHook(Node* node, OsiArgumentDesc* args, bool succeeded)
+{
+	RunHandlers(GetTrigger(node->Id, AfterTrigger), args);
+}
+
+namespace
+{
+	enum class IndexKeyType
+	{
+		None,
+		Integer,
+		Real,
+		String,
+		Guid
+	};
+
+	IndexKeyType GetIndexKeyType(ValueType type)
+	{
+		switch (type) {
+		case ValueType::Integer:
+		case ValueType::Integer64:
+			return IndexKeyType::Integer;
+
+		case ValueType::Real:
+			return IndexKeyType::Real;
+
+		case ValueType::String:
+			return IndexKeyType::String;
+
+		case ValueType::GuidString:
+		case ValueType::CharacterGuid:
+		case ValueType::ItemGuid:
+		case ValueType::TriggerGuid:
+		case ValueType::SplineGuid:
+		case ValueType::LevelTemplateGuid:
+			return IndexKeyType::Guid;
+
+		default:
+			return IndexKeyType::None;
+		}
+	}
+
+	constexpr uint64_t IndexHashBasis = 0xcbf29ce484222325ull;
+	constexpr uint64_t IndexHashPrime = 0x100000001b3ull;
+
+	inline uint64_t CombineIndexHash(uint64_t hash, uint64_t value)
+	{
+		return hash ^ (value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2));
+	}
+
+	inline uint64_t HashIndexInteger(int64_t value)
+	{
+		return (uint64_t)value * 0x9e3779b97f4a7c15ull;
+	}
+
+	// Case-insensitive FNV-1a, as string columns are compared using _stricmp()
+	uint64_t HashIndexString(char const* str, std::size_t len)
+	{
+		uint64_t hash = IndexHashBasis;
+		for (std::size_t i = 0; i < len; i++) {
+			hash = (hash ^ (uint8_t)std::tolower((uint8_t)str[i])) * IndexHashPrime;
+		}
+
+		return hash;
+	}
+
+	bool HashIndexString(IndexKeyType type, char const* str, uint64_t& hash)
+	{
+		if (str == nullptr) return false;
+
+		auto len = strlen(str);
+		if (type == IndexKeyType::Guid) {
+			// GUIDs are matched on the last 36 characters to ignore template name prefixes
+			if (len < 36) return false;
+			hash = HashIndexString(str + len - 36, 36);
+		} else {
+			hash = HashIndexString(str, len);
+		}
+
+		return true;
+	}
+
+	inline int64_t GetIndexInteger(TypedValue const& tv)
+	{
+		return ((ValueType)tv.TypeId == ValueType::Integer64) ? tv.Value.Val.Int64 : tv.Value.Val.Int32;
+	}
+
+	bool HashIndexValue(TypedValue const& tv, uint64_t& hash)
+	{
+		auto type = GetIndexKeyType((ValueType)tv.TypeId);
+		switch (type) {
+		case IndexKeyType::Integer:
+			hash = HashIndexInteger(GetIndexInteger(tv));
+			return true;
+
+		case IndexKeyType::String:
+		case IndexKeyType::Guid:
+			return HashIndexString(type, tv.Value.Val.String, hash);
+
+		default:
+			return false;
+		}
+	}
+
+	bool HashIndexValue(lua_State* L, int index, ValueType columnType, uint64_t& hash)
+	{
+		auto type = GetIndexKeyType(columnType);
+		switch (type) {
+		case IndexKeyType::Integer:
+			hash = HashIndexInteger(lua_tointeger(L, index));
+			return true;
+
+		case IndexKeyType::String:
+		case IndexKeyType::Guid:
+			return HashIndexString(type, lua_tostring(L, index), hash);
+
+		default:
+			return false;
+		}
+	}
+
+	bool IndexValuesEqual(TypedValue const& a, TypedValue const& b)
+	{
+		auto type = GetIndexKeyType((ValueType)a.TypeId);
+		if (type != GetIndexKeyType((ValueType)b.TypeId)) {
+			return false;
+		}
+
+		switch (type) {
+		case IndexKeyType::Integer:
+			return GetIndexInteger(a) == GetIndexInteger(b);
+
+		case IndexKeyType::Real:
+			return a.Value.Val.Float == b.Value.Val.Float;
+
+		case IndexKeyType::String:
+		case IndexKeyType::Guid:
+			return a.Value.Val.String != nullptr
+				&& b.Value.Val.String != nullptr
+				&& strcmp(a.Value.Val.String, b.Value.Val.String) == 0;
+
+		default:
+			return false;
+		}
 	}
 
-	RunHandlers(nodeRef, tuple);
+	bool FactEquals(TupleVec const& fact, TuplePtrLL const& tuple)
+	{
+		auto head = tuple.Items.Head;
+		auto cur = head->Next;
+		for (unsigned i = 0; i < fact.Size; i++, cur = cur->Next) {
+			if (cur == head || !IndexValuesEqual(fact.Values[i], *cur->Item)) {
+				return false;
+			}
+		}
+
+		return cur == head;
+	}
 }
 
-void OsirisCallbackManager::InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted)
+char * OsiStringArena::Allocate(char const * str, std::size_t len)
 {
-	uint64_t nodeRef = node->Id | AfterTriggerNodeRef;
+	auto size = len + 1;
+	while (block_ < blocks_.size() && offset_ + size > blocks_[block_].Size) {
+		// Move to the next block; oversized strings get a dedicated block
+		block_++;
+		offset_ = 0;
+		if (block_ < blocks_.size() && blocks_[block_].Size < size) {
+			blocks_[block_] = Block{ std::make_unique<char[]>(size), size };
+		}
+	}
+
+	if (block_ == blocks_.size()) {
+		auto blockSize = std::max(size, BlockSize);
+		blocks_.push_back(Block{ std::make_unique<char[]>(blockSize), blockSize });
+		offset_ = 0;
+	}
+
+	auto ptr = blocks_[block_].Data.get() + offset_;
+	memcpy(ptr, str, len);
+	ptr[len] = 0;
+	offset_ += size;
+	return ptr;
+}
+
+
+OsiFactGuidCache::OsiFactGuidCache(Vector<ValueType> const& columnTypes)
+{
+	slots_.resize(columnTypes.size(), -1);
+	for (uint32_t i = 0; i < columnTypes.size(); i++) {
+		if (GetIndexKeyType(columnTypes[i]) == IndexKeyType::Guid) {
+			slots_[i] = (int32_t)guidColumns_.size();
+			guidColumns_.push_back(i);
+		}
+	}
+}
+
+void OsiFactGuidCache::ParseQuery(lua_State* L, int firstIndex, Vector<OsiGuidValue>& guids) const
+{
+	guids.resize(guidColumns_.size());
+	for (std::size_t i = 0; i < guidColumns_.size(); i++) {
+		auto index = firstIndex + (int)guidColumns_[i];
+		if (lua_type(L, index) == LUA_TSTRING) {
+			ParseOsiGuid(lua_tostring(L, index), guids[i]);
+		}
+	}
+}
+
+char const* OsiFactGuidCache::GetGuidString(Fact const* fact, uint32_t slot) const
+{
+	auto const& tuple = fact->Item;
+	auto column = guidColumns_[slot];
+	if (column < tuple.Size && GetIndexKeyType((ValueType)tuple.Values[column].TypeId) == IndexKeyType::Guid) {
+		return tuple.Values[column].Value.Val.String;
+	} else {
+		return nullptr;
+	}
+}
+
+bool OsiFactGuidCache::IsRowCurrent(uint32_t row, Fact const* fact) const
+{
+	if (rowFacts_[row] != fact) return false;
+
+	auto numSlots = (uint32_t)guidColumns_.size();
+	auto strings = &strings_[row * numSlots];
+	for (uint32_t i = 0; i < numSlots; i++) {
+		if (strings[i] != GetGuidString(fact, i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void OsiFactGuidCache::ParseRow(uint32_t row, Fact const* fact)
+{
+	auto numSlots = (uint32_t)guidColumns_.size();
+	auto guids = &guids_[row * numSlots];
+	auto strings = &strings_[row * numSlots];
+	for (uint32_t i = 0; i < numSlots; i++) {
+		strings[i] = GetGuidString(fact, i);
+		guids[i] = OsiGuidValue{};
+		if (strings[i] != nullptr) {
+			ParseOsiGuid(strings[i], guids[i]);
+		}
+	}
+}
+
+uint32_t OsiFactGuidCache::AllocateRow(Fact const* fact)
+{
+	uint32_t row;
+	if (!freeRows_.empty()) {
+		row = freeRows_.back();
+		freeRows_.pop_back();
+	} else {
+		row = (uint32_t)rowFacts_.size();
+		rowFacts_.push_back(nullptr);
+		guids_.resize(rowFacts_.size() * guidColumns_.size());
+		strings_.resize(rowFacts_.size() * guidColumns_.size());
+	}
+
+	rowFacts_[row] = fact;
+	factRows_.insert(std::make_pair(fact, row));
+	return row;
+}
+
+OsiGuidValue const* OsiFactGuidCache::GetRow(uint32_t position, Fact const* fact)
+{
+	auto numSlots = guidColumns_.size();
+	if (position < positions_.size()) {
+		auto row = positions_[position];
+		if (row != InvalidRow && IsRowCurrent(row, fact)) {
+			return &guids_[row * numSlots];
+		}
+	} else {
+		positions_.resize(position + 1, InvalidRow);
+	}
+
+	// The fact moved in the list since the last scan, or wasn't seen yet
+	uint32_t row;
+	auto it = factRows_.find(fact);
+	if (it != factRows_.end()) {
+		row = it->second;
+		if (!IsRowCurrent(row, fact)) {
+			ParseRow(row, fact);
+		}
+	} else {
+		row = AllocateRow(fact);
+		ParseRow(row, fact);
+	}
+
+	positions_[position] = row;
+	return &guids_[row * numSlots];
+}
+
+void OsiFactGuidCache::InvalidateFact(TuplePtrLL const& tuple)
+{
+	auto numSlots = (uint32_t)guidColumns_.size();
+	auto& deleted = deletedGuids_;
+	deleted.clear();
+	deleted.resize(numSlots);
+
+	auto head = tuple.Items.Head;
+	auto cur = head->Next;
+	uint32_t column = 0;
+	for (uint32_t i = 0; i < numSlots; i++) {
+		while (column < guidColumns_[i] && cur != head) {
+			cur = cur->Next;
+			column++;
+		}
+
+		if (cur != head && GetIndexKeyType((ValueType)cur->Item->TypeId) == IndexKeyType::Guid) {
+			ParseOsiGuid(cur->Item->Value.Val.String, deleted[i]);
+		}
+	}
+
+	// The deleted fact has the same GUIDs as the tuple; other facts that share them are parsed again on the next scan
+	for (uint32_t row = 0; row < rowFacts_.size(); row++) {
+		if (rowFacts_[row] == nullptr) continue;
+
+		auto guids = &guids_[row * numSlots];
+		bool matches{ true };
+		for (uint32_t i = 0; i < numSlots && matches; i++) {
+			matches = (guids[i].Valid == deleted[i].Valid)
+				&& (!guids[i].Valid || guids[i].Value == deleted[i].Value);
+		}
+
+		if (matches) {
+			factRows_.erase(rowFacts_[row]);
+			rowFacts_[row] = nullptr;
+			freeRows_.push_back(row);
+		}
+	}
+}
+
+void OsiFactGuidCache::Clear()
+{
+	rowFacts_.clear();
+	guids_.clear();
+	strings_.clear();
+	freeRows_.clear();
+	factRows_.clear();
+	positions_.clear();
+}
+
+
+OsiDatabaseIndex::OsiDatabaseIndex(Database* db, Vector<uint32_t> const& columns, Vector<ValueType> const& columnTypes)
+	: db_(db), columns_(columns), columnTypes_(columnTypes)
+{}
+
+bool OsiDatabaseIndex::IsIndexableType(ValueType type)
+{
+	auto keyType = GetIndexKeyType(type);
+	return keyType == IndexKeyType::Integer
+		|| keyType == IndexKeyType::String
+		|| keyType == IndexKeyType::Guid;
+}
+
+bool OsiDatabaseIndex::CanLookup(lua_State* L, int firstIndex) const
+{
+	for (auto column : columns_) {
+		if (lua_isnil(L, firstIndex + (int)column)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::optional<OsiDatabaseIndex::FactRange> OsiDatabaseIndex::Lookup(lua_State* L, int firstIndex)
+{
+	CheckConsistency();
+	if (dirty_) {
+		Rebuild();
+	}
+
+	uint64_t hash = IndexHashBasis;
+	for (std::size_t i = 0; i < columns_.size(); i++) {
+		uint64_t valueHash;
+		if (!HashIndexValue(L, firstIndex + (int)columns_[i], columnTypes_[i], valueHash)) {
+			return {};
+		}
+
+		hash = CombineIndexHash(hash, valueHash);
+	}
+
+	return facts_.equal_range(hash);
+}
+
+void OsiDatabaseIndex::CheckConsistency()
+{
+	if (!dirty_ && db_->Facts.Size != numFacts_) {
+		dirty_ = true;
+	}
+}
+
+void OsiDatabaseIndex::Rebuild()
+{
+	facts_.clear();
+	facts_.reserve(db_->Facts.Size);
+	tail_ = nullptr;
+
+	auto head = db_->Facts.Head;
+	for (auto cur = head->Next; cur != head; cur = cur->Next) {
+		uint64_t hash;
+		if (HashFact(cur->Item, hash)) {
+			facts_.insert(std::make_pair(hash, cur));
+		}
+
+		tail_ = cur;
+	}
+
+	numFacts_ = db_->Facts.Size;
+	dirty_ = false;
+}
+
+bool OsiDatabaseIndex::HashFact(TupleVec const& fact, uint64_t& hash) const
+{
+	hash = IndexHashBasis;
+	for (auto column : columns_) {
+		uint64_t valueHash;
+		if (column >= fact.Size || !HashIndexValue(fact.Values[column], valueHash)) {
+			return false;
+		}
+
+		hash = CombineIndexHash(hash, valueHash);
+	}
+
+	return true;
+}
+
+bool OsiDatabaseIndex::HashTuple(TuplePtrLL const& tuple, uint64_t& hash) const
+{
+	hash = IndexHashBasis;
+	auto head = tuple.Items.Head;
+	auto cur = head->Next;
+	uint32_t column = 0;
+	for (auto indexedColumn : columns_) {
+		while (column < indexedColumn && cur != head) {
+			cur = cur->Next;
+			column++;
+		}
+
+		uint64_t valueHash;
+		if (cur == head || !HashIndexValue(*cur->Item, valueHash)) {
+			return false;
+		}
+
+		hash = CombineIndexHash(hash, valueHash);
+	}
+
+	return true;
+}
+
+OsiDatabaseIndex::Fact* OsiDatabaseIndex::FindFact(uint64_t hash, TuplePtrLL const& tuple) const
+{
+	auto range = facts_.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (FactEquals(it->second->Item, tuple)) {
+			return it->second;
+		}
+	}
+
+	return nullptr;
+}
+
+void OsiDatabaseIndex::InsertPreHook(TuplePtrLL* tuple, bool deleted)
+{
+	CheckConsistency();
+	if (!deleted) return;
+
+	// The fact is freed by the time the post hook runs, so it must be located beforehand
+	PendingDelete pending{ 0, nullptr };
+	if (!dirty_ && HashTuple(*tuple, pending.Hash)) {
+		pending.Deleted = FindFact(pending.Hash, *tuple);
+	}
+
+	pendingDeletes_.push_back(pending);
+}
+
+void OsiDatabaseIndex::InsertPostHook(TuplePtrLL* tuple, bool deleted)
+{
+	auto numFacts = db_->Facts.Size;
+
 	if (deleted) {
-		nodeRef |= DeleteTriggerNodeRef;
+		if (pendingDeletes_.empty()) {
+			dirty_ = true;
+			return;
+		}
+
+		auto pending = pendingDeletes_.back();
+		pendingDeletes_.pop_back();
+
+		// Fact didn't exist
+		if (dirty_ || numFacts == numFacts_) return;
+
+		if (numFacts + 1 == numFacts_ && pending.Deleted != nullptr) {
+			auto range = facts_.equal_range(pending.Hash);
+			for (auto it = range.first; it != range.second; ++it) {
+				if (it->second == pending.Deleted) {
+					facts_.erase(it);
+					break;
+				}
+			}
+
+			if (tail_ == pending.Deleted) {
+				tail_ = nullptr;
+			}
+
+			numFacts_ = numFacts;
+		} else {
+			dirty_ = true;
+		}
+
+		return;
+	}
+
+	// Fact already existed
+	if (dirty_ || numFacts == numFacts_) return;
+
+	if (numFacts == numFacts_ + 1) {
+		// Osiris doesn't report where the fact was inserted; check the end and the start of the list
+		auto head = db_->Facts.Head;
+		Fact* inserted{ nullptr };
+		if (tail_ != nullptr && tail_->Next != head && FactEquals(tail_->Next->Item, *tuple)) {
+			inserted = tail_->Next;
+		} else if (head->Next != head && FactEquals(head->Next->Item, *tuple)) {
+			inserted = head->Next;
+		}
+
+		if (inserted != nullptr) {
+			uint64_t hash;
+			if (HashFact(inserted->Item, hash)) {
+				facts_.insert(std::make_pair(hash, inserted));
+			}
+
+			if (inserted->Next == head) {
+				tail_ = inserted;
+			}
+
+			numFacts_ = numFacts;
+			return;
+		}
 	}
 
-	RunHandlers(nodeRef, tuple);
+	dirty_ = true;
 }
 
-void OsirisCallbackManager::CallQueryPreHook(Node* node, OsiArgumentDesc* args)
+
+OsirisDatabaseIndexManager::~OsirisDatabaseIndexManager()
 {
-	RunHandlers(node->Id, args);
+	auto wrappers = gExtender->GetServer().Osiris().GetVMTWrappers();
+	if (wrappers && wrappers->DatabaseIndexAttachment == this) {
+		wrappers->DatabaseIndexAttachment = nullptr;
+	}
 }
 
-void OsirisCallbackManager::CallQueryPostHook(Node* node, OsiArgumentDesc* args, bool succeeded)
+void OsirisDatabaseIndexManager::CreateIndex(Function const* func, Vector<uint32_t> const& columns)
+{
+	STDString name(func->Signature->Name);
+	auto arity = (uint32_t)func->Signature->Params->Params.Size;
+	for (auto const& def : definitions_) {
+		if (def.Name == name && def.Arity == arity && def.Columns == columns) {
+			return;
+		}
+	}
+
+	definitions_.push_back(IndexDefinition{ name, arity, columns });
+	BindIndex(func, columns);
+}
+
+OsiDatabaseIndex* OsirisDatabaseIndexManager::FindIndex(Database* db, lua_State* L, int firstIndex)
 {
-	uint64_t nodeRef = node->Id | AfterTriggerNodeRef;
-	RunHandlers(nodeRef, args);
+	if (indexes_.empty()) return nullptr;
+
+	auto it = indexes_.find(db);
+	if (it == indexes_.end()) return nullptr;
+
+	OsiDatabaseIndex* best{ nullptr };
+	for (auto const& index : it->second) {
+		if (index->CanLookup(L, firstIndex)
+			&& (best == nullptr || index->Columns().size() > best->Columns().size())) {
+			best = index.get();
+		}
+	}
+
+	return best;
 }
 
+OsiFactGuidCache* OsirisDatabaseIndexManager::GetGuidCache(Function const* func, lua_State* L, int firstIndex)
+{
+	if (!hooked_) return nullptr;
+
+	auto db = func->Node.Get()->Database.Get();
+	if (db->Facts.Size < MinGuidCacheFacts) return nullptr;
+
+	auto it = guidCaches_.find(db);
+	if (it == guidCaches_.end()) {
+		Vector<ValueType> columnTypes;
+		auto head = func->Signature->Params->Params.Head;
+		for (auto param = head->Next; param != head; param = param->Next) {
+			columnTypes.push_back((ValueType)param->Item.Type);
+		}
+
+		it = guidCaches_.insert(std::make_pair(db, std::make_unique<OsiFactGuidCache>(columnTypes))).first;
+	}
+
+	for (auto column : it->second->GuidColumns()) {
+		if (!lua_isnil(L, firstIndex + (int)column)) {
+			return it->second.get();
+		}
+	}
 
+	return nullptr;
+}
+
+void OsirisDatabaseIndexManager::StoryLoaded()
+{
+	HookOsiris();
+	indexes_.clear();
+	guidCaches_.clear();
+	for (auto const& def : definitions_) {
+		auto func = LookupOsiFunction(def.Name, def.Arity);
+		if (func != nullptr && func->Type == FunctionType::Database) {
+			BindIndex(func, def.Columns);
+		}
+	}
+}
+
+void OsirisDatabaseIndexManager::ClearIndexes()
+{
+	indexes_.clear();
+	guidCaches_.clear();
+}
+
+void OsirisDatabaseIndexManager::BindIndex(Function const* func, Vector<uint32_t> const& columns)
+{
+	auto node = func->Node.Get();
+	auto db = node ? node->Database.Get() : nullptr;
+	if (db == nullptr) {
+		OsiWarn("Couldn't create index on '" << func->Signature->Name << "': Function is not a database");
+		return;
+	}
+
+	Vector<ValueType> paramTypes;
+	auto head = func->Signature->Params->Params.Head;
+	for (auto param = head->Next; param != head; param = param->Next) {
+		paramTypes.push_back((ValueType)param->Item.Type);
+	}
+
+	Vector<ValueType> columnTypes;
+	for (auto column : columns) {
+		columnTypes.push_back(paramTypes[column]);
+	}
+
+	HookOsiris();
+	indexes_[db].push_back(std::make_unique<OsiDatabaseIndex>(db, columns, columnTypes));
+}
+
+void OsirisDatabaseIndexManager::HookOsiris()
+{
+	auto& osiris = gExtender->GetServer().Osiris();
+	if (osiris.GetVMTWrappers() == nullptr) {
+		osiris.HookNodeVMTs();
+	}
+
+	auto wrappers = osiris.GetVMTWrappers();
+	if (wrappers) {
+		wrappers->DatabaseIndexAttachment = this;
+		hooked_ = true;
+	}
+}
+
+void OsirisDatabaseIndexManager::InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted)
+{
+	if (deleted && !guidCaches_.empty()) {
+		auto cache = guidCaches_.find(node->Database.Get());
+		if (cache != guidCaches_.end()) {
+			cache->second->InvalidateFact(*tuple);
+		}
+	}
+
+	if (indexes_.empty()) return;
+
+	auto it = indexes_.find(node->Database.Get());
+	if (it != indexes_.end()) {
+		for (auto const& index : it->second) {
+			index->InsertPreHook(tuple, deleted);
+		}
+	}
+}
+
+void OsirisDatabaseIndexManager::InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted)
+{
+	if (indexes_.empty()) return;
+
+	auto it = indexes_.find(node->Database.Get());
+	if (it != indexes_.end()) {
+		for (auto const& index : it->second) {
+			index->InsertPostHook(tuple, deleted);
+		}
+	}
+}
 
 
 OsirisBinding::OsirisBinding(ExtensionState& state)
@@ -277,11 +991,16 @@ void OsirisBinding::StoryLoaded()
 	}
 
 	osirisCallbacks_.StoryLoaded();
+	databaseIndexes_.StoryLoaded();
 }
 
 void OsirisBinding::StorySetMerging(bool isMerging)
 {
 	osirisCallbacks_.StorySetMerging(isMerging);
+	if (isMerging) {
+		// Databases are rebuilt during the merge; indexes are bound again when the story is loaded
+		databaseIndexes_.ClearIndexes();
+	}
 }
 
 }
@@ -54,13 +54,34 @@ BEGIN_NS(esv::lua)
 
 using namespace dse::lua;
 
-void LuaToOsi(lua_State * L, int i, TypedValue & tv, ValueType osiType, bool allowNil = false);
+class OsiStringArena;
+
+// If a string arena is passed, string values are allocated from the arena instead of the heap
+void LuaToOsi(lua_State * L, int i, TypedValue & tv, ValueType osiType, bool allowNil = false, OsiStringArena * strings = nullptr);
 TypedValue * LuaToOsi(lua_State * L, int i, ValueType osiType, bool allowNil = false);
-void LuaToOsi(lua_State * L, int i, OsiArgumentValue & arg, ValueType osiType, bool allowNil = false, bool reuseStrings = false);
+void LuaToOsi(lua_State * L, int i, OsiArgumentValue & arg, ValueType osiType, bool allowNil = false, bool reuseStrings = false,
+	OsiStringArena * strings = nullptr);
 void OsiToLua(lua_State * L, OsiArgumentValue const & arg);
 void OsiToLua(lua_State * L, TypedValue const & tv);
 Function const* LookupOsiFunction(STDString const& name, uint32_t arity);
 
+// Binary form of the GUID part (last 36 characters) of an Osiris GUID string.
+// The value is only meant for equality checks; it doesn't use the byte order of game GUIDs.
+struct OsiGuidValue
+{
+	Guid Value;
+	bool Valid{ false };
+};
+
+// Parses the GUID part of a GUID string. Name prefixes (eg. "S_Player_Ifan_") are ignored,
+// the same way as when GUID strings are compared; strings without a well-formed GUID part are not parsed.
+bool ParseOsiGuid(char const* str, OsiGuidValue& guid);
+// Compares the GUID part of two GUID strings. The binary forms are compared if both were parsed,
+// otherwise the strings are compared case-insensitively.
+bool OsiGuidStringsEqual(char const* a, OsiGuidValue const* parsedA, char const* b, OsiGuidValue const* parsedB);
+
+class OsiFactGuidCache;
+
 class OsiFunction
 {
 public:
@@ -81,6 +102,8 @@ public:
 	int LuaGet(lua_State * L);
 	int LuaDelete(lua_State * L);
 	int LuaDeferredNotification(lua_State * L);
+	int LuaCreateIndex(lua_State * L);
+	int LuaBatch(lua_State * L);
 
 private:
 	Function const * function_{ nullptr };
@@ -92,8 +115,12 @@ private:
 	void OsiInsert(lua_State * L, bool deleteTuple);
 	int OsiQuery(lua_State * L);
 	int OsiUserQuery(lua_State * L);
+	void OsiBatchCall(lua_State * L, uint32_t numTuples);
+	void OsiBatchInsert(lua_State * L, uint32_t numTuples);
+	int PushBatchTuple(lua_State * L, uint32_t index, uint32_t numArgs);
 
-	bool MatchTuple(lua_State * L, int firstIndex, TupleVec const & tuple);
+	bool MatchTuple(lua_State * L, int firstIndex, TupleVec const & tuple, OsiFactGuidCache const * guidCache = nullptr,
+		OsiGuidValue const * queryGuids = nullptr, OsiGuidValue const * factGuids = nullptr);
 	void ConstructTuple(lua_State * L, TupleVec const & tuple);
 };
 
@@ -121,6 +148,8 @@ private:
 	static int LuaGet(lua_State * L);
 	static int LuaDelete(lua_State * L);
 	static int LuaDeferredNotification(lua_State * L);
+	static int LuaCreateIndex(lua_State * L);
+	static int LuaBatch(lua_State * L);
 	bool BeforeCall(lua_State * L);
 	OsiFunction * TryGetFunction(uint32_t arity);
 	OsiFunction * CreateFunctionMapping(uint32_t arity, Function const * func);
@@ -165,48 +194,112 @@ inline void OsiReleaseArgument(TypedValue & arg) {}
 inline void OsiReleaseArgument(ListNode<TypedValue *> & arg) {}
 inline void OsiReleaseArgument(ListNode<TupleLL::Item> & arg) {}
 
+// Stack allocator for the argument lists of Osiris calls made from Lua.
+// Arguments are allocated from fixed-size chunks, so the address of arguments that are in use never changes
+// when the pool grows; chunks are kept after release and reused by later calls.
 template <class T>
 class OsiArgumentPool
 {
 public:
+	static constexpr uint32_t ChunkSize = 1024;
+
+	struct Allocation
+	{
+		// Top of the pool before the allocation
+		uint32_t PrevChunk;
+		uint32_t PrevOffset;
+		// Location of the allocated arguments
+		uint32_t Chunk;
+		uint32_t Offset;
+	};
+
+	struct Stats
+	{
+		uint32_t Chunks{ 0 };
+		uint32_t Capacity{ 0 };
+		uint32_t InUse{ 0 };
+		uint32_t HighWaterMark{ 0 };
+		uint64_t Allocations{ 0 };
+	};
+
 	OsiArgumentPool()
 	{
-		argumentPool_.resize(1024);
-		usedArguments_ = 0;
+		AddChunk(ChunkSize);
 	}
 
-	T * AllocateArguments(uint32_t num, uint32_t & tail)
+	T * AllocateArguments(uint32_t num, Allocation & alloc)
 	{
-		if (usedArguments_ + num > argumentPool_.size()) {
-			throw std::runtime_error("Ran out of argument descriptors");
+		alloc.PrevChunk = chunk_;
+		alloc.PrevOffset = offset_;
+
+		// Arguments must be contiguous; skip to the next chunk if they don't fit in the current one
+		while (offset_ + num > chunks_[chunk_].Size) {
+			chunk_++;
+			offset_ = 0;
+			if (chunk_ == chunks_.size()) {
+				AddChunk(std::max(num, ChunkSize));
+			} else if (chunks_[chunk_].Size < num) {
+				// Chunks above the top of the pool are unused, so they can be replaced
+				stats_.Capacity -= chunks_[chunk_].Size;
+				chunks_[chunk_] = Chunk{ std::make_unique<T[]>(num), num };
+				stats_.Capacity += num;
+			}
 		}
 
-		tail = usedArguments_;
-		auto ptr = argumentPool_.data() + usedArguments_;
+		alloc.Chunk = chunk_;
+		alloc.Offset = offset_;
+
+		auto ptr = chunks_[chunk_].Items.get() + offset_;
 		for (uint32_t i = 0; i < num; i++) {
 			new (ptr + i) T();
 		}
 
-		usedArguments_ += num;
+		offset_ += num;
+		stats_.InUse += num;
+		stats_.HighWaterMark = std::max(stats_.HighWaterMark, stats_.InUse);
+		stats_.Allocations++;
 		return ptr;
 	}
 
-	void ReleaseArguments(uint32_t tail, uint32_t num)
+	void ReleaseArguments(Allocation const & alloc, uint32_t num)
 	{
-		if (tail + num != usedArguments_) {
+		if (alloc.Chunk != chunk_ || alloc.Offset + num != offset_) {
 			throw std::runtime_error("Attempted to release arguments out of order");
 		}
 
+		auto ptr = chunks_[chunk_].Items.get() + alloc.Offset;
 		for (uint32_t i = 0; i < num; i++) {
-			OsiReleaseArgument(argumentPool_[tail + i]);
+			OsiReleaseArgument(ptr[i]);
 		}
 
-		usedArguments_ -= num;
+		chunk_ = alloc.PrevChunk;
+		offset_ = alloc.PrevOffset;
+		stats_.InUse -= num;
+	}
+
+	inline Stats const & GetStats() const
+	{
+		return stats_;
 	}
 
 private:
-	std::vector<T> argumentPool_;
-	uint32_t usedArguments_;
+	struct Chunk
+	{
+		std::unique_ptr<T[]> Items;
+		uint32_t Size;
+	};
+
+	std::vector<Chunk> chunks_;
+	uint32_t chunk_{ 0 };
+	uint32_t offset_{ 0 };
+	Stats stats_;
+
+	void AddChunk(uint32_t size)
+	{
+		chunks_.push_back(Chunk{ std::make_unique<T[]>(size), size });
+		stats_.Chunks = (uint32_t)chunks_.size();
+		stats_.Capacity += size;
+	}
 };
 
 template <class T>
@@ -216,12 +309,12 @@ public:
 	inline OsiArgumentListPin(OsiArgumentPool<T> & pool, uint32_t numArgs)
 		: pool_(pool), numArgs_(numArgs)
 	{
-		args_ = pool.AllocateArguments(numArgs_, tail_);
+		args_ = pool.AllocateArguments(numArgs_, alloc_);
 	}
 
 	inline ~OsiArgumentListPin()
 	{
-		pool_.ReleaseArguments(tail_, numArgs_);
+		pool_.ReleaseArguments(alloc_, numArgs_);
 	}
 
 	inline T * Args() const
@@ -232,10 +325,73 @@ public:
 private:
 	OsiArgumentPool<T> & pool_;
 	uint32_t numArgs_;
-	uint32_t tail_;
+	typename OsiArgumentPool<T>::Allocation alloc_;
 	T * args_;
 };
 
+// Bump allocator for the string arguments of Osiris calls made from Lua.
+// Strings are released in LIFO order using OsiStringArenaPin, so nested calls
+// (eg. an Osiris listener that calls Osiris) can share the arena.
+class OsiStringArena : Noncopyable<OsiStringArena>
+{
+public:
+	static constexpr std::size_t BlockSize = 0x4000;
+
+	struct Mark
+	{
+		std::size_t Block;
+		std::size_t Offset;
+	};
+
+	char * Allocate(char const * str, std::size_t len);
+
+	inline Mark GetMark() const
+	{
+		return Mark{ block_, offset_ };
+	}
+
+	inline void Release(Mark mark)
+	{
+		block_ = mark.Block;
+		offset_ = mark.Offset;
+	}
+
+private:
+	struct Block
+	{
+		std::unique_ptr<char[]> Data;
+		std::size_t Size;
+	};
+
+	// Blocks are kept after the arena is released and reused by later calls
+	std::vector<Block> blocks_;
+	std::size_t block_{ 0 };
+	std::size_t offset_{ 0 };
+};
+
+// Releases strings allocated during an Osiris call when the call completes or throws
+class OsiStringArenaPin
+{
+public:
+	inline OsiStringArenaPin(OsiStringArena & arena)
+		: arena_(arena), mark_(arena.GetMark())
+	{}
+
+	inline ~OsiStringArenaPin()
+	{
+		arena_.Release(mark_);
+	}
+
+	inline OsiStringArena * Arena() const
+	{
+		return &arena_;
+	}
+
+private:
+	OsiStringArena & arena_;
+	OsiStringArena::Mark mark_;
+};
+
 
 class ServerState;
 
@@ -255,13 +411,27 @@ public:
 	void CallQueryPostHook(Node* node, OsiArgumentDesc* args, bool succeeded);
 
 private:
-	static constexpr uint64_t AfterTriggerNodeRef = 0x8000000000000000ull;
-	static constexpr uint64_t DeleteTriggerNodeRef = 0x4000000000000000ull;
+	// Trigger flags; node triggers are identified by (node ID << 2) | flags
+	static constexpr uint32_t AfterTrigger = 1;
+	static constexpr uint32_t DeleteTrigger = 2;
+
+	// Handlers of a node trigger, stored contiguously in nodeHandlerIds_
+	struct NodeHandlerRange
+	{
+		uint32_t First{ 0 };
+		uint32_t Count{ 0 };
+	};
 
 	ExtensionState& state_;
 	std::vector<RegistryEntry> subscribers_;
 	std::unordered_multimap<OsirisHookSignature, std::size_t> nameSubscriberRefs_;
-	std::unordered_multimap<uint64_t, std::size_t> nodeSubscriberRefs_;
+	// Handlers registered for node triggers in the current story (trigger, handler ID)
+	std::vector<std::pair<uint64_t, std::size_t>> nodeSubscriberRefs_;
+	// Dense lookup tables built from nodeSubscriberRefs_, indexed by trigger;
+	// they only extend up to the highest subscribed node, as nodes above that have no handlers.
+	std::vector<uint64_t> nodeTriggerBits_;
+	std::vector<NodeHandlerRange> nodeHandlers_;
+	std::vector<std::size_t> nodeHandlerIds_;
 	bool storyLoaded_{ false };
 	bool osirisHooked_{ false };
 	// Are we currently merging Osiris files (story)?
@@ -270,14 +440,183 @@ private:
 	bool merging_{ false };
 
 	void RegisterNodeHandler(OsirisHookSignature const& sig, std::size_t handlerId);
+	void RebuildNodeHandlers();
 	void HookOsiris();
 
-	void RunHandlers(uint64_t nodeRef, TuplePtrLL* tuple) const;
+	static inline uint64_t GetTrigger(uint32_t nodeId, uint32_t flags)
+	{
+		return ((uint64_t)nodeId << 2) | flags;
+	}
+
+	inline bool HasHandlers(uint64_t trigger) const
+	{
+		auto word = trigger >> 6;
+		return word < nodeTriggerBits_.size()
+			&& (nodeTriggerBits_[word] & (1ull << (trigger & 63))) != 0;
+	}
+
+	void RunHandlers(uint64_t trigger, TuplePtrLL* tuple) const;
 	void RunHandler(ServerState& lua, RegistryEntry const& func, TuplePtrLL* tuple) const;
-	void RunHandlers(uint64_t nodeRef, OsiArgumentDesc* tuple) const;
+	void RunHandlers(uint64_t trigger, OsiArgumentDesc* tuple) const;
 	void RunHandler(ServerState& lua, RegistryEntry const& func, OsiArgumentDesc* tuple) const;
 };
 
+// Parsed GUID columns of the facts of a database.
+// Rows are owned by the list node of the fact and are validated by the string pointers of the fact.
+// Rows are also remembered by their position in the fact list, so scans in list order don't need
+// a hash lookup per fact unless facts were inserted or deleted before the position since the last scan.
+// Rows of deleted facts must be invalidated, as the list nodes and strings of deleted facts may be reused.
+class OsiFactGuidCache : Noncopyable<OsiFactGuidCache>
+{
+public:
+	using Fact = ListNode<TupleVec>;
+
+	OsiFactGuidCache(Vector<ValueType> const& columnTypes);
+
+	// Returns the slot of the column in GUID rows, or -1 if the column is not a GUID column
+	inline int32_t GetSlot(uint32_t column) const
+	{
+		return column < slots_.size() ? slots_[column] : -1;
+	}
+
+	inline uint32_t NumSlots() const
+	{
+		return (uint32_t)guidColumns_.size();
+	}
+
+	inline Vector<uint32_t> const& GuidColumns() const
+	{
+		return guidColumns_;
+	}
+
+	// Parses the bound GUID arguments of a query starting at the specified stack index
+	void ParseQuery(lua_State* L, int firstIndex, Vector<OsiGuidValue>& guids) const;
+	// Returns the GUIDs of the fact at the specified position of the fact list
+	OsiGuidValue const* GetRow(uint32_t position, Fact const* fact);
+	// Drops the rows of facts whose GUID columns match the tuple that is about to be deleted
+	void InvalidateFact(TuplePtrLL const& tuple);
+	void Clear();
+
+private:
+	static constexpr uint32_t InvalidRow = 0xffffffffu;
+
+	// Column -> slot mapping
+	Vector<int32_t> slots_;
+	Vector<uint32_t> guidColumns_;
+	// Row -> owning fact; null for free rows
+	std::vector<Fact const*> rowFacts_;
+	// GUIDs and the string pointers they were parsed from, NumSlots() entries per row
+	std::vector<OsiGuidValue> guids_;
+	std::vector<char const*> strings_;
+	std::vector<uint32_t> freeRows_;
+	std::unordered_map<Fact const*, uint32_t> factRows_;
+	// Fact list position -> row, as of the last scan
+	std::vector<uint32_t> positions_;
+	// Reused between deletes to avoid allocations
+	std::vector<OsiGuidValue> deletedGuids_;
+
+	bool IsRowCurrent(uint32_t row, Fact const* fact) const;
+	void ParseRow(uint32_t row, Fact const* fact);
+	uint32_t AllocateRow(Fact const* fact);
+	char const* GetGuidString(Fact const* fact, uint32_t slot) const;
+};
+
+// Secondary index on a subset of the columns of an Osiris database.
+// Facts are bucketed by the combined hash of the indexed columns; candidates returned by a lookup
+// may share a hash with the query without matching it, so they must still be checked by the caller.
+class OsiDatabaseIndex : Noncopyable<OsiDatabaseIndex>
+{
+public:
+	using Fact = ListNode<TupleVec>;
+	using FactMap = std::unordered_multimap<uint64_t, Fact*>;
+	using FactRange = std::pair<FactMap::const_iterator, FactMap::const_iterator>;
+
+	OsiDatabaseIndex(Database* db, Vector<uint32_t> const& columns, Vector<ValueType> const& columnTypes);
+
+	inline Vector<uint32_t> const& Columns() const
+	{
+		return columns_;
+	}
+
+	// Checks whether all indexed columns are bound in the query starting at the specified stack index
+	bool CanLookup(lua_State* L, int firstIndex) const;
+	// Returns the facts whose indexed columns may match the query, or nothing if the query can't be hashed
+	std::optional<FactRange> Lookup(lua_State* L, int firstIndex);
+
+	void InsertPreHook(TuplePtrLL* tuple, bool deleted);
+	void InsertPostHook(TuplePtrLL* tuple, bool deleted);
+
+	static bool IsIndexableType(ValueType type);
+
+private:
+	struct PendingDelete
+	{
+		uint64_t Hash;
+		Fact* Deleted;
+	};
+
+	Database* db_;
+	// Indexed columns in ascending order
+	Vector<uint32_t> columns_;
+	Vector<ValueType> columnTypes_;
+	FactMap facts_;
+	// Number of facts in the database when the index was last updated;
+	// used to detect changes that the insert/delete hooks couldn't follow
+	uint64_t numFacts_{ 0 };
+	// Last fact in the list, if known; new facts are usually appended after it
+	Fact* tail_{ nullptr };
+	bool dirty_{ true };
+	// Facts being deleted, one entry per (possibly nested) delete call
+	std::vector<PendingDelete> pendingDeletes_;
+
+	void Rebuild();
+	void CheckConsistency();
+	bool HashFact(TupleVec const& fact, uint64_t& hash) const;
+	bool HashTuple(TuplePtrLL const& tuple, uint64_t& hash) const;
+	Fact* FindFact(uint64_t hash, TuplePtrLL const& tuple) const;
+};
+
+// Keeps the secondary indexes of Osiris databases in sync with the story.
+// Index definitions are kept by name so they can be rebound after a story reload.
+class OsirisDatabaseIndexManager : Noncopyable<OsirisDatabaseIndexManager>
+{
+public:
+	~OsirisDatabaseIndexManager();
+
+	// Columns are zero-based and must be in ascending order
+	void CreateIndex(Function const* func, Vector<uint32_t> const& columns);
+	// Returns the index that covers the most bound columns of the query, if any
+	OsiDatabaseIndex* FindIndex(Database* db, lua_State* L, int firstIndex);
+	// Returns the GUID cache of the database if the query has bound GUID columns and the database is large enough
+	OsiFactGuidCache* GetGuidCache(Function const* func, lua_State* L, int firstIndex);
+	void StoryLoaded();
+	// Drops all bound indexes and GUID caches; database pointers are no longer valid after this point
+	void ClearIndexes();
+
+	void InsertPreHook(Node* node, TuplePtrLL* tuple, bool deleted);
+	void InsertPostHook(Node* node, TuplePtrLL* tuple, bool deleted);
+
+private:
+	struct IndexDefinition
+	{
+		STDString Name;
+		uint32_t Arity;
+		Vector<uint32_t> Columns;
+	};
+
+	// Databases with fewer facts are scanned without caching GUIDs
+	static constexpr uint32_t MinGuidCacheFacts = 32;
+
+	Vector<IndexDefinition> definitions_;
+	std::unordered_map<Database*, Vector<std::unique_ptr<OsiDatabaseIndex>>> indexes_;
+	std::unordered_map<Database*, std::unique_ptr<OsiFactGuidCache>> guidCaches_;
+	// Caches can only be kept while we're notified about deletes
+	bool hooked_{ false };
+
+	void BindIndex(Function const* func, Vector<uint32_t> const& columns);
+	void HookOsiris();
+};
+
 class OsirisBinding : Noncopyable<OsirisBinding>
 {
 public:
@@ -299,6 +638,11 @@ public:
 		return argDescPool_;
 	}
 
+	inline OsiStringArena & GetStringArena()
+	{
+		return stringArena_;
+	}
+
 	inline OsiArgumentPool<TypedValue> & GetTypedValuePool()
 	{
 		return tvPool_;
@@ -319,6 +663,11 @@ public:
 		return osirisCallbacks_;
 	}
 
+	inline OsirisDatabaseIndexManager& GetDatabaseIndexes()
+	{
+		return databaseIndexes_;
+	}
+
 	void StoryLoaded();
 	void StorySetMerging(bool isMerging);
 
@@ -327,11 +676,13 @@ private:
 	OsiArgumentPool<TypedValue> tvPool_;
 	OsiArgumentPool<ListNode<TypedValue *>> tvNodePool_;
 	OsiArgumentPool<ListNode<TupleLL::Item>> tupleNodePool_;
+	OsiStringArena stringArena_;
 	IdentityAdapterMap identityAdapters_;
 	// ID of current story instance.
 	// Used to invalidate function/node pointers in Lua userdata objects
 	uint32_t generationId_{ 0 };
 	OsirisCallbackManager osirisCallbacks_;
+	OsirisDatabaseIndexManager databaseIndexes_;
 };
 
 END_NS()
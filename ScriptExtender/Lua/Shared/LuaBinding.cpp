@@ -287,9 +287,24 @@ namespace dse::lua
 	}
 
 
+	// Called by Event.lua to create the subscriber list of an engine event
+	int RegisterEngineEvent(lua_State* L)
+	{
+		std::size_t len;
+		auto name = luaL_checklstring(L, 1, &len);
+		auto event = State::FromLua(L)->GetOrCreateEvent(StringView(name, len));
+		SubscribableEventProxy::New(L, event);
+		return 1;
+	}
+
 	void ExtensionLibrary::Register(lua_State * L)
 	{
 		RegisterLib(L);
+
+		lua_getglobal(L, "Ext"); // stack: Ext
+		lua_pushcfunction(L, &RegisterEngineEvent);
+		lua_setfield(L, -2, "_RegisterEngineEvent");
+		lua_pop(L, 1);
 	}
 
 
@@ -492,7 +507,10 @@ namespace dse::lua
 		luaJIT_setmode(L, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON);
 #endif
 		lua_atpanic(L, &LuaPanic);
+		nativeMathTypes_ = gExtender->HasFeatureFlag("NativeMathTypes");
+		gcScheduler_.SetBudget(gExtender->GetConfig().LuaGCBudget);
 		OpenLibs();
+		gcScheduler_.Attach(L);
 	}
 
 	void RestoreLevelMaps(bool isClient);
@@ -500,6 +518,11 @@ namespace dse::lua
 	State::~State()
 	{
 		lifetimePool_.Release(globalLifetime_);
+		// Handler references must be released before the state is closed
+		for (auto& event : events_) {
+			event.second->Clear();
+		}
+
 		lua_close(L);
 		if (internal_) {
 			lua_release_internal_state(internal_);
@@ -702,18 +725,18 @@ namespace dse::lua
 		ThrowEvent("NetMessageReceived", params);
 	}
 
-	EventResult State::DispatchEvent(EventBase& evt, char const* eventName, bool canPreventAction, uint32_t restrictions)
+	EventResult State::DispatchEvent(SubscribableEvent& event, EventBase& evt, bool canPreventAction, uint32_t restrictions)
 	{
-		auto stackSize = lua_gettop(L) - 2;
+		auto stackSize = lua_gettop(L) - 1;
+		auto eventName = event.GetName().GetStringOrDefault();
 
 		try {
 			Restriction restriction(*this, restrictions);
-			evt.Name = FixedString(eventName);
+			evt.Name = event.GetName();
 			evt.CanPreventAction = canPreventAction;
 
-			if (!CheckedCall(L, 1, "_ThrowEvent")) {
-				return EventResult::Failed;
-			}
+			event.Throw(L, -1, &evt);
+			lua_pop(L, 1);
 
 			if (evt.ActionPrevented) {
 				return EventResult::ActionPrevented;
@@ -734,6 +757,33 @@ namespace dse::lua
 		}
 	}
 
+	SubscribableEvent* State::GetEvent(StringView eventName) const
+	{
+		auto it = events_.find(eventName);
+		return (it != events_.end()) ? it->second.get() : nullptr;
+	}
+
+	SubscribableEvent* State::GetOrCreateEvent(StringView eventName)
+	{
+		auto event = GetEvent(eventName);
+		if (event == nullptr) {
+			auto newEvent = std::make_unique<SubscribableEvent>(FixedString(eventName));
+			newEvent->SetProfiling(eventProfiling_);
+			event = newEvent.get();
+			events_.insert(std::make_pair(STDString(eventName), std::move(newEvent)));
+		}
+
+		return event;
+	}
+
+	void State::SetEventProfiling(bool enabled)
+	{
+		eventProfiling_ = enabled;
+		for (auto& event : events_) {
+			event.second->SetProfiling(enabled);
+		}
+	}
+
 	void State::OnGameSessionLoading()
 	{
 		EmptyEvent params;
@@ -774,6 +824,10 @@ namespace dse::lua
 	{
 		variableManager_.Invalidate();
 		modVariableManager_.Invalidate();
+
+		if (gExtender->GetConfig().LuaGCFullCollectOnLoad) {
+			gcScheduler_.FullCollect(L);
+		}
 	}
 
 	void State::OnResetCompleted()
@@ -787,7 +841,7 @@ namespace dse::lua
 		TickEvent params{ .Time = time };
 		ThrowEvent("Tick", params, false, 0);
 
-		lua_gc(L, LUA_GCSTEP, 10);
+		gcScheduler_.OnTick(L);
 		variableManager_.Flush();
 		modVariableManager_.Flush();
 	}
@@ -2,6 +2,8 @@
 
 #include <Lua/Shared/LuaHelpers.h>
 #include <Lua/Shared/LuaLifetime.h>
+#include <Lua/Shared/LuaGCScheduler.h>
+#include <Lua/Shared/LuaProfiler.h>
 
 #include <Lua/Shared/Proxies/LuaArrayProxy.h>
 #include <Lua/Shared/Proxies/LuaMapProxy.h>
@@ -14,6 +16,7 @@
 #include <Lua/Shared/Proxies/LuaEnumValue.h>
 #include <Lua/Shared/Proxies/LuaBitfieldValue.h>
 #include <Lua/Shared/Proxies/LuaUserVariableHolder.h>
+#include <Lua/Shared/Proxies/LuaMathValue.h>
 
 #include <GameDefinitions/Components/Character.h>
 #include <GameDefinitions/Components/Item.h>
@@ -212,6 +215,12 @@ namespace dse::lua
 			return startupDone_;
 		}
 
+		// Return vectors and matrices as MathValue userdata instead of tables
+		inline bool UseNativeMathTypes() const
+		{
+			return nativeMathTypes_;
+		}
+
 		LifetimeHandle GetCurrentLifetime();
 
 		inline LifetimeHandle GetGlobalLifetime()
@@ -224,6 +233,16 @@ namespace dse::lua
 			return lifetimePool_;
 		}
 
+		inline GCScheduler& GetGCScheduler()
+		{
+			return gcScheduler_;
+		}
+
+		inline SamplingProfiler& GetProfiler()
+		{
+			return profiler_;
+		}
+
 		inline CppMetatableManager& GetMetatableManager()
 		{
 			return metatableManager_;
@@ -283,26 +302,57 @@ namespace dse::lua
 		std::optional<int> GetCharacterWeaponAnimationSetType(stats::Character* character);
 		void OnNetMessageReceived(STDString const & channel, STDString const & payload, UserId userId);
 
+		SubscribableEvent* GetEvent(StringView eventName) const;
+		SubscribableEvent* GetOrCreateEvent(StringView eventName);
+
+		inline auto const& GetEvents() const
+		{
+			return events_;
+		}
+
+		// Enables latency histograms for all engine events
+		void SetEventProfiling(bool enabled);
+
+		inline bool IsEventProfilingEnabled() const
+		{
+			return eventProfiling_;
+		}
+
+		// Returns whether any Lua handler is subscribed to the specified engine event
+		inline bool HasEventSubscribers(char const* eventName) const
+		{
+			auto event = GetEvent(eventName);
+			return event != nullptr && event->HasSubscribers();
+		}
+
 		template <class TEvent>
 		EventResult ThrowEvent(char const* eventName, TEvent& evt, bool canPreventAction = false, uint32_t restrictions = 0)
 		{
 			static_assert(std::is_base_of_v<EventBase, TEvent>, "Event object must be a descendant of EventBase");
+			// Don't enter Lua at all if nobody is listening
+			auto event = GetEvent(eventName);
+			if (event == nullptr || !event->HasSubscribers()) {
+				return EventResult::Successful;
+			}
+
 			StackCheck _(L, 0);
 			LifetimeStackPin _p(GetStack());
-			PushInternalFunction(L, "_ThrowEvent");
 			LightObjectProxyByRefMetatable::Make(L, &evt, GetCurrentLifetime());
-			return DispatchEvent(evt, eventName, canPreventAction, restrictions);
+			return DispatchEvent(*event, evt, canPreventAction, restrictions);
 		}
 
 	protected:
 		lua_State * L;
 		LuaInternalState* internal_{ nullptr };
 		bool startupDone_{ false };
+		bool nativeMathTypes_{ false };
 		uint32_t generationId_;
 
 		LifetimePool lifetimePool_;
 		LifetimeStack lifetimeStack_;
 		LifetimeHandle globalLifetime_;
+		GCScheduler gcScheduler_;
+		SamplingProfiler profiler_;
 
 		CppMetatableManager metatableManager_;
 
@@ -312,8 +362,22 @@ namespace dse::lua
 		CachedUserVariableManager variableManager_;
 		CachedModVariableManager modVariableManager_;
 
+		struct EventNameHash
+		{
+			using is_transparent = void;
+
+			inline std::size_t operator ()(StringView name) const
+			{
+				return std::hash<StringView>{}(name);
+			}
+		};
+
+		// Subscriber lists of engine events, indexed by event name
+		std::unordered_map<STDString, std::unique_ptr<SubscribableEvent>, EventNameHash, std::equal_to<>> events_;
+		bool eventProfiling_{ false };
+
 		void OpenLibs();
-		EventResult DispatchEvent(EventBase& evt, char const* eventName, bool canPreventAction, uint32_t restrictions);
+		EventResult DispatchEvent(SubscribableEvent& event, EventBase& evt, bool canPreventAction, uint32_t restrictions);
 	};
 
 	class Restriction
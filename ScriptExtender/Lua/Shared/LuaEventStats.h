@@ -0,0 +1,118 @@
+#pragma once
+
+#include <bit>
+#include <chrono>
+
+BEGIN_NS(lua)
+
+// Log-linear (HDR-style) latency histogram.
+// Values are bucketed by their highest set bit, and each power of two is split into
+// 2^SubBucketBits linear sub-buckets, giving ~6% relative precision over the whole range.
+class LatencyHistogram
+{
+public:
+	static constexpr unsigned SubBucketBits = 4;
+	static constexpr unsigned SubBucketCount = 1 << SubBucketBits;
+	// Largest tracked value is 2^(MaxShift + SubBucketBits + 1) - 1 ns (~73 minutes)
+	static constexpr unsigned MaxShift = 37;
+	static constexpr unsigned BucketCount = (MaxShift + 2) * SubBucketCount;
+
+	inline void Record(uint64_t value)
+	{
+		buckets_[GetBucketIndex(value)]++;
+		count_++;
+		total_ += value;
+		if (value > max_) max_ = value;
+	}
+
+	inline uint64_t Count() const
+	{
+		return count_;
+	}
+
+	inline uint64_t Total() const
+	{
+		return total_;
+	}
+
+	inline uint64_t Max() const
+	{
+		return max_;
+	}
+
+	inline uint64_t Mean() const
+	{
+		return count_ ? (total_ / count_) : 0;
+	}
+
+	// Returns the highest value equivalent to the value at the specified percentile (0 - 100)
+	uint64_t Percentile(double percentile) const
+	{
+		if (count_ == 0) return 0;
+
+		auto target = (uint64_t)std::ceil(count_ * std::clamp(percentile, 0.0, 100.0) / 100.0);
+		if (target == 0) target = 1;
+
+		uint64_t seen{ 0 };
+		for (unsigned i = 0; i < BucketCount; i++) {
+			seen += buckets_[i];
+			if (seen >= target) {
+				return std::min(GetBucketValue(i), max_);
+			}
+		}
+
+		return max_;
+	}
+
+	void Reset()
+	{
+		buckets_.fill(0);
+		count_ = 0;
+		total_ = 0;
+		max_ = 0;
+	}
+
+private:
+	std::array<uint32_t, BucketCount> buckets_{};
+	uint64_t count_{ 0 };
+	uint64_t total_{ 0 };
+	uint64_t max_{ 0 };
+
+	static inline unsigned GetBucketIndex(uint64_t value)
+	{
+		if (value < SubBucketCount) {
+			return (unsigned)value;
+		}
+
+		auto shift = (unsigned)std::bit_width(value) - SubBucketBits - 1;
+		if (shift > MaxShift) {
+			return BucketCount - 1;
+		}
+
+		auto subBucket = (unsigned)(value >> shift) - SubBucketCount;
+		return (shift + 1) * SubBucketCount + subBucket;
+	}
+
+	static inline uint64_t GetBucketValue(unsigned index)
+	{
+		if (index < SubBucketCount) {
+			return index;
+		}
+
+		auto shift = index / SubBucketCount - 1;
+		auto subBucket = (uint64_t)(index % SubBucketCount + SubBucketCount);
+		return (subBucket << shift) + ((1ull << shift) - 1);
+	}
+};
+
+// Handler latency statistics, aggregated by the source location of the handler function
+struct EventHandlerStats
+{
+	// Chunk name and line where the handler was defined
+	STDString Source;
+	// Mod that owns the handler, derived from the chunk name
+	STDString Mod;
+	LatencyHistogram Latency;
+};
+
+END_NS()
@@ -0,0 +1,139 @@
+#include <stdafx.h>
+#include <Lua/Shared/LuaGCScheduler.h>
+
+BEGIN_NS(lua)
+
+namespace
+{
+	constexpr float EmaWeight = 0.1f;
+
+	inline float UpdateAverage(float average, float sample)
+	{
+		return (average == 0.0f) ? sample : (average + (sample - average) * EmaWeight);
+	}
+
+	inline float ElapsedUs(GCScheduler::Clock::time_point start, GCScheduler::Clock::time_point end)
+	{
+		return std::chrono::duration<float, std::micro>(end - start).count();
+	}
+}
+
+std::size_t GCScheduler::GetHeapSize(lua_State* L)
+{
+	return (std::size_t)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + (std::size_t)lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+void GCScheduler::SetBudget(uint32_t budgetUs)
+{
+	budgetUs_ = std::max(budgetUs, 1u);
+}
+
+void GCScheduler::Attach(lua_State* L)
+{
+	lua_gc(L, LUA_GCSTOP, 0);
+	lastHeapSize_ = GetHeapSize(L);
+}
+
+void GCScheduler::OnTick(lua_State* L)
+{
+	auto tickStart = Clock::now();
+	stats_.Ticks++;
+
+	// Scripts may restart the automatic collector via collectgarbage("restart")
+	if (lua_gc(L, LUA_GCISRUNNING, 0)) {
+		lua_gc(L, LUA_GCSTOP, 0);
+	}
+
+	float frameTimeUs{ 0.0f };
+	if (lastTick_) {
+		frameTimeUs = ElapsedUs(*lastTick_, tickStart);
+	}
+	lastTick_ = tickStart;
+
+	auto heapSize = GetHeapSize(L);
+	auto allocatedKb = (uint32_t)((heapSize > lastHeapSize_) ? (heapSize - lastHeapSize_) / 1024 : 0);
+	stats_.HeapSizeKb = (uint32_t)(heapSize / 1024);
+	if (frameTimeUs > 0.0f) {
+		stats_.AllocationRateKbPerSec = UpdateAverage(stats_.AllocationRateKbPerSec, allocatedKb * 1000000.0f / frameTimeUs);
+	}
+
+	// Nothing was allocated since the last cycle was finished, there's no garbage to collect
+	if (allocatedKb == 0 && cycleCompleted_) {
+		stats_.SkippedTicks++;
+		stats_.LastTickTimeUs = 0;
+		lastHeapSize_ = heapSize;
+		if (frameTimeUs > 0.0f) {
+			stats_.FrameTimeUs = UpdateAverage(stats_.FrameTimeUs, frameTimeUs);
+		}
+		return;
+	}
+
+	// Use less of the budget if the frame is already running long
+	float budgetUs = (float)budgetUs_;
+	if (stats_.FrameTimeUs > 0.0f && frameTimeUs > stats_.FrameTimeUs * 2.0f) {
+		budgetUs *= 0.5f;
+	}
+
+	if (frameTimeUs > 0.0f) {
+		stats_.FrameTimeUs = UpdateAverage(stats_.FrameTimeUs, frameTimeUs);
+	}
+
+	// Keep pace with the allocation rate; when idle, advance the current cycle by a minimum step
+	auto workKb = std::max((uint32_t)(allocatedKb * WorkMultiplier), MinStepSizeKb);
+	uint32_t doneKb{ 0 };
+	float elapsedUs{ 0.0f };
+
+	while (doneKb < workKb) {
+		// Size the step to the remaining budget based on the measured cost of previous steps
+		uint32_t stepKb = MinStepSizeKb;
+		if (stats_.StepCostUsPerKb > 0.0f) {
+			stepKb = (uint32_t)std::clamp((budgetUs - elapsedUs) / stats_.StepCostUsPerKb, (float)MinStepSizeKb, (float)MaxStepSizeKb);
+		}
+		stepKb = std::max(std::min(stepKb, workKb - doneKb), MinStepSizeKb);
+
+		auto stepStart = Clock::now();
+		bool completed = lua_gc(L, LUA_GCSTEP, (int)stepKb) == 1;
+		auto stepEnd = Clock::now();
+
+		stats_.StepCostUsPerKb = UpdateAverage(stats_.StepCostUsPerKb, ElapsedUs(stepStart, stepEnd) / stepKb);
+		stats_.Steps++;
+		stats_.LastStepSizeKb = stepKb;
+		doneKb += stepKb;
+		elapsedUs = ElapsedUs(tickStart, stepEnd);
+
+		cycleCompleted_ = completed;
+		if (completed) {
+			stats_.CompletedCycles++;
+			break;
+		}
+
+		if (elapsedUs >= budgetUs) {
+			if (doneKb < workKb) {
+				stats_.BudgetExhaustedTicks++;
+			}
+			break;
+		}
+	}
+
+	lastHeapSize_ = GetHeapSize(L);
+	stats_.HeapSizeKb = (uint32_t)(lastHeapSize_ / 1024);
+	stats_.LastTickTimeUs = (uint32_t)elapsedUs;
+	stats_.MaxTickTimeUs = std::max(stats_.MaxTickTimeUs, stats_.LastTickTimeUs);
+	stats_.TotalTimeUs += stats_.LastTickTimeUs;
+}
+
+void GCScheduler::FullCollect(lua_State* L)
+{
+	auto start = Clock::now();
+	lua_gc(L, LUA_GCCOLLECT, 0);
+	auto timeUs = (uint64_t)ElapsedUs(start, Clock::now());
+
+	cycleCompleted_ = true;
+	lastHeapSize_ = GetHeapSize(L);
+
+	stats_.FullCollections++;
+	stats_.FullCollectionTimeUs += timeUs;
+	stats_.HeapSizeKb = (uint32_t)(lastHeapSize_ / 1024);
+}
+
+END_NS()
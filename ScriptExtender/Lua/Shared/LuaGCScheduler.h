@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Lua/Shared/LuaHelpers.h>
+#include <chrono>
+
+BEGIN_NS(lua)
+
+// Runs incremental GC steps once per tick, sized so that the collector keeps up with the
+// allocation rate of the state while staying within a fixed time budget per frame.
+// Lua's automatic collector is stopped while the scheduler owns the state, so all collection work
+// happens in the budgeted steps (explicit LUA_GCSTEP/LUA_GCCOLLECT calls still work when stopped).
+class GCScheduler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Step sizes (in KB of allocation debt) passed to LUA_GCSTEP
+	static constexpr uint32_t MinStepSizeKb = 4;
+	static constexpr uint32_t MaxStepSizeKb = 1024;
+	// Amount of work to perform relative to the amount of memory allocated since the last tick
+	static constexpr float WorkMultiplier = 2.0f;
+
+	struct Stats
+	{
+		uint64_t Ticks{ 0 };
+		uint64_t Steps{ 0 };
+		uint64_t SkippedTicks{ 0 };
+		uint64_t BudgetExhaustedTicks{ 0 };
+		uint64_t CompletedCycles{ 0 };
+		uint64_t FullCollections{ 0 };
+		uint64_t TotalTimeUs{ 0 };
+		uint64_t FullCollectionTimeUs{ 0 };
+		uint32_t LastTickTimeUs{ 0 };
+		uint32_t MaxTickTimeUs{ 0 };
+		uint32_t LastStepSizeKb{ 0 };
+		uint32_t HeapSizeKb{ 0 };
+		// Exponential moving averages
+		float AllocationRateKbPerSec{ 0.0f };
+		float StepCostUsPerKb{ 0.0f };
+		float FrameTimeUs{ 0.0f };
+	};
+
+	// Budget is specified in microseconds per tick
+	void SetBudget(uint32_t budgetUs);
+
+	inline uint32_t GetBudget() const
+	{
+		return budgetUs_;
+	}
+
+	inline Stats const& GetStats() const
+	{
+		return stats_;
+	}
+
+	// Takes over collection from Lua's automatic collector
+	void Attach(lua_State* L);
+	void OnTick(lua_State* L);
+	// Performs a full collection immediately (eg. during load screens)
+	void FullCollect(lua_State* L);
+
+private:
+	Stats stats_;
+	uint32_t budgetUs_{ 1000 };
+	// Whether the last step completed a GC cycle; no work is needed until the heap grows again
+	bool cycleCompleted_{ false };
+	std::size_t lastHeapSize_{ 0 };
+	std::optional<Clock::time_point> lastTick_;
+
+	static std::size_t GetHeapSize(lua_State* L);
+};
+
+END_NS()
@@ -79,6 +79,7 @@ struct MathParam
 {
 	union {
 		float f;
+		glm::vec2 vec2;
 		glm::vec3 vec3;
 		glm::vec4 vec4;
 		glm::quat quat;
@@ -524,6 +525,7 @@ inline std::optional<T> checked_get_param(lua_State* L, int i, Overload<std::opt
 }
 
 
+int TracebackHandler(lua_State* L);
 int CallWithTraceback(lua_State* L, int narg, int nres);
 
 // Calls Lua function.
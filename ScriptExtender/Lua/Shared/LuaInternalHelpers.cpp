@@ -332,6 +332,10 @@ void set_raw(Table* tab, glm::mat4 const& m)
 glm::vec2 do_get(lua_State* L, int index, Overload<glm::vec2>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::vec2>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 2);
 	return get_raw(L, arr, Overload<glm::vec2>{});
 }
@@ -339,6 +343,10 @@ glm::vec2 do_get(lua_State* L, int index, Overload<glm::vec2>)
 glm::vec3 do_get(lua_State* L, int index, Overload<glm::vec3>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::vec3>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 3);
 	return get_raw(L, arr, Overload<glm::vec3>{});
 }
@@ -346,6 +354,10 @@ glm::vec3 do_get(lua_State* L, int index, Overload<glm::vec3>)
 glm::vec4 do_get(lua_State* L, int index, Overload<glm::vec4>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::vec4>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 4);
 	return get_raw(L, arr, Overload<glm::vec4>{});
 }
@@ -353,6 +365,10 @@ glm::vec4 do_get(lua_State* L, int index, Overload<glm::vec4>)
 glm::quat do_get(lua_State* L, int index, Overload<glm::quat>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::quat>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 4);
 	return get_raw(L, arr, Overload<glm::quat>{});
 }
@@ -360,6 +376,10 @@ glm::quat do_get(lua_State* L, int index, Overload<glm::quat>)
 glm::mat3 do_get(lua_State* L, int index, Overload<glm::mat3>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::mat3>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 9);
 	return get_raw(L, arr, Overload<glm::mat3>{});
 }
@@ -367,6 +387,10 @@ glm::mat3 do_get(lua_State* L, int index, Overload<glm::mat3>)
 glm::mat3x4 do_get(lua_State* L, int index, Overload<glm::mat3x4>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::mat3x4>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 12);
 	return get_raw(L, arr, Overload<glm::mat3x4>{});
 }
@@ -374,6 +398,10 @@ glm::mat3x4 do_get(lua_State* L, int index, Overload<glm::mat3x4>)
 glm::mat4x3 do_get(lua_State* L, int index, Overload<glm::mat4x3>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::mat4x3>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 12);
 	return get_raw(L, arr, Overload<glm::mat4x3>{});
 }
@@ -381,6 +409,10 @@ glm::mat4x3 do_get(lua_State* L, int index, Overload<glm::mat4x3>)
 glm::mat4 do_get(lua_State* L, int index, Overload<glm::mat4>)
 {
 	auto i = lua_absindex(L, index);
+	if (lua_type(L, i) == LUA_TUSERDATA) {
+		return MathValue::CheckedGet<glm::mat4>(L, i);
+	}
+
 	auto arr = lua_get_array_n(L, i, 16);
 	return get_raw(L, arr, Overload<glm::mat4>{});
 }
@@ -393,6 +425,17 @@ MathParam do_get(lua_State* L, int index, Overload<MathParam>)
 	if (ttisnumber(arg)) {
 		val.f = lua_val_get_float(L, arg);
 		val.Arity = 1;
+	} else if (ttisfulluserdata(arg)) {
+		auto native = MathValue::CheckUserData(L, i);
+		val.Arity = native->Arity();
+		switch (val.Arity) {
+		case 2: val.vec2 = MathValue::CheckedGet<glm::vec2>(L, i); break;
+		case 3: val.vec3 = MathValue::CheckedGet<glm::vec3>(L, i); break;
+		case 4: val.vec4 = MathValue::CheckedGet<glm::vec4>(L, i); break;
+		case 9: val.mat3 = MathValue::CheckedGet<glm::mat3>(L, i); break;
+		case 16: val.mat4 = MathValue::CheckedGet<glm::mat4>(L, i); break;
+		default: luaL_error(L, "Param %d: Unsupported vector or matrix size (%d)", index, val.Arity); break;
+		}
 	} else if (ttistable(arg)) {
 		auto tab = hvalue(arg);
 		if (tab->lsizenode > 0) {
@@ -401,6 +444,7 @@ MathParam do_get(lua_State* L, int index, Overload<MathParam>)
 
 		val.Arity = lua_get_array_size(tab);
 		switch (val.Arity) {
+		case 2: val.vec2 = get_raw(L, tab, Overload<glm::vec2>{}); break;
 		case 3: val.vec3 = get_raw(L, tab, Overload<glm::vec3>{}); break;
 		case 4: val.vec4 = get_raw(L, tab, Overload<glm::vec4>{}); break;
 		case 9: val.mat3 = get_raw(L, tab, Overload<glm::mat3>{}); break;
@@ -417,6 +461,11 @@ MathParam do_get(lua_State* L, int index, Overload<MathParam>)
 
 void push(lua_State* L, glm::vec2 const& v)
 {
+	if (State::FromLua(L)->UseNativeMathTypes()) {
+		MathValue::Make(L, v);
+		return;
+	}
+
 	lua_createtable(L, 2, 0);
 	auto tab = lua_get_top_table_unsafe(L);
 	set_raw(tab, v);
@@ -424,6 +473,11 @@ void push(lua_State* L, glm::vec2 const& v)
 
 void push(lua_State* L, glm::vec3 const& v)
 {
+	if (State::FromLua(L)->UseNativeMathTypes()) {
+		MathValue::Make(L, v);
+		return;
+	}
+
 	lua_createtable(L, 3, 0);
 	auto tab = lua_get_top_table_unsafe(L);
 	set_raw(tab, v);
@@ -431,6 +485,11 @@ void push(lua_State* L, glm::vec3 const& v)
 
 void push(lua_State* L, glm::vec4 const& v)
 {
+	if (State::FromLua(L)->UseNativeMathTypes()) {
+		MathValue::Make(L, v);
+		return;
+	}
+
 	lua_createtable(L, 4, 0);
 	auto tab = lua_get_top_table_unsafe(L);
 	set_raw(tab, v);
@@ -445,6 +504,11 @@ void push(lua_State* L, glm::quat const& v)
 
 void push(lua_State* L, glm::mat3 const& m)
 {
+	if (State::FromLua(L)->UseNativeMathTypes()) {
+		MathValue::Make(L, m);
+		return;
+	}
+
 	lua_createtable(L, 9, 0);
 	auto tab = lua_get_top_table_unsafe(L);
 	set_raw(tab, m);
@@ -466,6 +530,11 @@ void push(lua_State* L, glm::mat4x3 const& m)
 
 void push(lua_State* L, glm::mat4 const& m)
 {
+	if (State::FromLua(L)->UseNativeMathTypes()) {
+		MathValue::Make(L, m);
+		return;
+	}
+
 	lua_createtable(L, 16, 0);
 	auto tab = lua_get_top_table_unsafe(L);
 	set_raw(tab, m);
@@ -519,42 +588,77 @@ PersistentRegistryEntry do_get(lua_State* L, int index, Overload<PersistentRegis
 
 void assign(lua_State* L, int idx, glm::vec2 const& v)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, v);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 2);
 	set_raw(tab, v);
 }
 
 void assign(lua_State* L, int idx, glm::vec3 const& v)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, v);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 3);
 	set_raw(tab, v);
 }
 
 void assign(lua_State* L, int idx, glm::vec4 const& v)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, v);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 4);
 	set_raw(tab, v);
 }
 
 void assign(lua_State* L, int idx, glm::quat const& v)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, v);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 4);
 	set_raw(tab, v);
 }
 
 void assign(lua_State* L, int idx, glm::mat3 const& m)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, m);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 9);
 	set_raw(tab, m);
 }
 
 void assign(lua_State* L, int idx, glm::mat3x4 const& m)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, m);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 12);
 	set_raw(tab, m);
 }
 
 void assign(lua_State* L, int idx, glm::mat4 const& m)
 {
+	if (lua_type(L, idx) == LUA_TUSERDATA) {
+		MathValue::CheckedAssign(L, idx, m);
+		return;
+	}
+
 	auto tab = lua_get_array_n(L, idx, 16);
 	set_raw(tab, m);
 }
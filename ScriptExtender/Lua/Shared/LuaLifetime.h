@@ -5,6 +5,7 @@
 
 BEGIN_NS(lua)
 
+// Fixed-size pool that finds free slots using a 3-level bitmap
 template <class T, std::size_t Size>
 class HierarchicalPoolAllocator
 {
@@ -12,7 +13,7 @@ public:
 	static constexpr unsigned PageBits = 64;
 	static constexpr unsigned PageShift = 6;
 
-	HierarchicalPoolAllocator()
+	HierarchicalPoolAllocator(std::size_t baseIndex = 0, uint32_t initialSalt = 0)
 	{
 		pool_ = new T[Size];
 		memset(pool_, 0, sizeof(T) * Size);
@@ -22,11 +23,12 @@ public:
 
 		auto l1buckets = Size / (PageBits * PageBits);
 		if (l1buckets % PageBits) {
-			l1_[std::size(l1_) - 1] = 0xffffffffffffffffull << (PageBits - (l1buckets & (PageBits - 1)));
+			l1_[std::size(l1_) - 1] = 0xffffffffffffffffull >> (PageBits - (l1buckets & (PageBits - 1)));
 		}
 
 		for (std::size_t i = 0; i < Size; i++) {
-			pool_[i].SetIndex(i);
+			pool_[i].SetIndex(baseIndex + i);
+			pool_[i].SetSalt(initialSalt);
 		}
 	}
 
@@ -35,6 +37,7 @@ public:
 		delete [] pool_;
 	}
 
+	// Returns nullptr if the pool is full
 	T* Allocate()
 	{
 		for (auto i = 0; i < std::size(l1_); i++) {
@@ -63,11 +66,11 @@ public:
 
 				auto lifetime = pool_ + off;
 				lifetime->Acquire();
+				used_++;
 				return lifetime;
 			}
 		}
 
-		OsiErrorS("Couldn't allocate Lua lifetime - pool is full! This is very, very bad.");
 		return nullptr;
 	}
 
@@ -97,6 +100,7 @@ public:
 		}
 
 		ptr->Release();
+		used_--;
 	}
 
 	T* Get(std::size_t index) const
@@ -105,6 +109,31 @@ public:
 		return pool_ + index;
 	}
 
+	inline std::size_t Used() const
+	{
+		return used_;
+	}
+
+	inline bool IsFull() const
+	{
+		return used_ == Size;
+	}
+
+	inline bool IsEmpty() const
+	{
+		return used_ == 0;
+	}
+
+	uint32_t MaxSalt() const
+	{
+		uint32_t salt{ 0 };
+		for (std::size_t i = 0; i < Size; i++) {
+			salt = std::max(salt, pool_[i].Salt());
+		}
+
+		return salt;
+	}
+
 public:
 	static_assert((Size % 4096) == 0, "Size must be a multiple of 4096");
 
@@ -112,6 +141,109 @@ public:
 	uint64_t l2_[Size / 4096];
 	uint64_t l3_[Size / 64];
 	T* pool_;
+	std::size_t used_{ 0 };
+};
+
+// Pool that grows by adding fixed-size hierarchical segments as needed.
+// Object indices encode the segment index in their upper bits, so indices remain stable
+// when new segments are added. Empty segments at the end of the pool are released when the
+// segment that empties last (in any position) leaves only empty segments behind it.
+template <class T, unsigned SegmentBits, std::size_t MaxSegments>
+class SegmentedPoolAllocator
+{
+public:
+	static constexpr std::size_t SegmentSize = 1ull << SegmentBits;
+	using Segment = HierarchicalPoolAllocator<T, SegmentSize>;
+
+	SegmentedPoolAllocator()
+	{
+		AddSegment();
+	}
+
+	T* Allocate()
+	{
+		for (auto i = freeHint_; i < segments_.size(); i++) {
+			if (!segments_[i]->IsFull()) {
+				freeHint_ = i;
+				return segments_[i]->Allocate();
+			}
+		}
+
+		if (segments_.size() >= MaxSegments) {
+			OsiErrorS("Couldn't allocate Lua lifetime - pool is full! This is very, very bad.");
+			return nullptr;
+		}
+
+		freeHint_ = segments_.size();
+		return AddSegment().Allocate();
+	}
+
+	void Free(T* ptr)
+	{
+		auto segmentIndex = ptr->Index() >> SegmentBits;
+		assert(segmentIndex < segments_.size());
+		auto& segment = *segments_[segmentIndex];
+		segment.Free(ptr);
+
+		if (segmentIndex < freeHint_) {
+			freeHint_ = segmentIndex;
+		}
+
+		// Under LIFO release the trailing segments empty first, so shrinking must also be attempted
+		// when an earlier segment empties; ReleaseTrailingSegments() stops at the first non-empty one
+		if (segment.IsEmpty()) {
+			ReleaseTrailingSegments();
+		}
+	}
+
+	T* Get(std::size_t index) const
+	{
+		auto segmentIndex = index >> SegmentBits;
+		if (segmentIndex >= segments_.size()) {
+			return nullptr;
+		}
+
+		return segments_[segmentIndex]->Get(index & (SegmentSize - 1));
+	}
+
+	inline std::size_t Capacity() const
+	{
+		return segments_.size() * SegmentSize;
+	}
+
+	inline auto const& Segments() const
+	{
+		return segments_;
+	}
+
+private:
+	std::vector<std::unique_ptr<Segment>> segments_;
+	// Lowest segment that may have free slots
+	std::size_t freeHint_{ 0 };
+	// Initial salt of objects in each segment; ensures that handles to objects in a released
+	// segment won't match objects in a segment that was reallocated at the same position
+	std::array<uint32_t, MaxSegments> saltBase_{};
+
+	Segment& AddSegment()
+	{
+		auto index = segments_.size();
+		segments_.push_back(std::make_unique<Segment>(index << SegmentBits, saltBase_[index]));
+		return *segments_.back();
+	}
+
+	void ReleaseTrailingSegments()
+	{
+		// Keep one empty segment around to avoid reallocating when usage fluctuates around a segment boundary
+		while (segments_.size() > 1
+			&& segments_[segments_.size() - 1]->IsEmpty()
+			&& segments_[segments_.size() - 2]->IsEmpty()) {
+			auto index = segments_.size() - 1;
+			saltBase_[index] = segments_[index]->MaxSalt() + 1;
+			segments_.pop_back();
+		}
+
+		freeHint_ = std::min(freeHint_, segments_.size() - 1);
+	}
 };
 
 class LifetimePool;
@@ -119,7 +251,7 @@ class LifetimePool;
 class Lifetime : public Noncopyable<Lifetime>
 {
 public:
-	static constexpr uint32_t SaltMask = (1ull << 30) - 1;
+	static constexpr uint32_t SaltMask = (1ull << 24) - 1;
 
 	inline Lifetime()
 	{}
@@ -174,6 +306,11 @@ public:
 		index_ = (uint32_t)i;
 	}
 
+	inline void SetSalt(uint32_t salt)
+	{
+		salt_ = (salt & SaltMask);
+	}
+
 protected:
 	friend class LifetimeReference;
 	friend class LifetimePin;
@@ -189,9 +326,12 @@ private:
 struct LifetimeHandle
 {
 	static constexpr unsigned HandleBits = 48;
-	static constexpr unsigned IndexBits = 18;
+	// Index of the lifetime; upper bits are the pool segment index, lower bits are the index within the segment
+	static constexpr unsigned IndexBits = 24;
+	static constexpr unsigned SegmentBits = 16;
 	static constexpr unsigned SaltBits = (HandleBits - IndexBits);
 	static constexpr unsigned MaxPoolSize = 1 << IndexBits;
+	static constexpr unsigned MaxSegments = 1 << (IndexBits - SegmentBits);
 	static constexpr uint64_t IndexMask = (1ull << IndexBits) - 1;
 	static constexpr uint64_t SaltMask = (1ull << SaltBits) - 1;
 	static constexpr uint64_t HandleMask = (1ull << HandleBits) - 1;
@@ -289,7 +429,7 @@ public:
 		auto ref = pool_.Get(handle.GetIndex());
 		if (ref == nullptr) {
 #if defined(DEBUG_LIFETIMES)
-			ERR("[%012lx] Attempted to get lifetime with invalid index %d (max is %d).", (uint64_t)handle, handle.GetIndex(), LifetimeHandle::MaxPoolSize);
+			ERR("[%012lx] Attempted to get lifetime with invalid index %d (pool size is %d).", (uint64_t)handle, handle.GetIndex(), pool_.Capacity());
 #endif
 			return nullptr;
 		}
@@ -311,6 +451,17 @@ public:
 		return ref;
 	}
 
+	// Same checks as Get(), without logging; for callers that expect stale handles
+	inline bool IsAlive(LifetimeHandle handle)
+	{
+		if (!handle) return false;
+
+		auto ref = pool_.Get(handle.GetIndex());
+		return ref != nullptr
+			&& ref->Salt() == handle.GetSalt()
+			&& ref->IsAlive();
+	}
+
 	inline void Release(LifetimeHandle handle)
 	{
 		auto ref = Get(handle);
@@ -325,7 +476,7 @@ public:
 	}
 
 private:
-	HierarchicalPoolAllocator<Lifetime, LifetimeHandle::MaxPoolSize> pool_;
+	SegmentedPoolAllocator<Lifetime, LifetimeHandle::SegmentBits, LifetimeHandle::MaxSegments> pool_;
 };
 
 class LifetimeStack
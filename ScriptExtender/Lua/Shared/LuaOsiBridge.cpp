@@ -42,7 +42,7 @@ namespace dse::esv::lua
 		return 0;
 	}
 
-	char * LuaToString(lua_State* L, int i, int type, char* reuseString)
+	char * LuaToString(lua_State* L, int i, int type, char* reuseString, OsiStringArena* strings)
 	{
 		if (type == LUA_TSTRING) {
 			if (reuseString != nullptr) {
@@ -50,6 +50,10 @@ namespace dse::esv::lua
 				auto s = lua_tolstring(L, i, &len);
 				strncpy_s(reuseString, 0x100, s, len);
 				return reuseString;
+			} else if (strings != nullptr) {
+				size_t len;
+				auto s = lua_tolstring(L, i, &len);
+				return strings->Allocate(s, len);
 			} else {
 				// TODO - not sure if we're the owners of the string or the TypedValue is
 				return _strdup(lua_tostring(L, i));
@@ -70,7 +74,7 @@ namespace dse::esv::lua
 		return nullptr;
 	}
 
-	void LuaToOsi(lua_State * L, int i, TypedValue & tv, ValueType osiType, bool allowNil)
+	void LuaToOsi(lua_State * L, int i, TypedValue & tv, ValueType osiType, bool allowNil, OsiStringArena * strings)
 	{
 		tv.VMT = gExtender->GetServer().Osiris().GetGlobals().TypedValueVMT;
 		tv.TypeId = (uint32_t)osiType;
@@ -113,7 +117,7 @@ namespace dse::esv::lua
 		case ValueType::TriggerGuid:
 		case ValueType::SplineGuid:
 		case ValueType::LevelTemplateGuid:
-			tv.Value.Val.String = LuaToString(L, i, type, nullptr);
+			tv.Value.Val.String = LuaToString(L, i, type, nullptr, strings);
 			break;
 
 		default:
@@ -129,7 +133,8 @@ namespace dse::esv::lua
 		return tv;
 	}
 
-	void LuaToOsi(lua_State * L, int i, OsiArgumentValue & arg, ValueType osiType, bool allowNil, bool reuseStrings)
+	void LuaToOsi(lua_State * L, int i, OsiArgumentValue & arg, ValueType osiType, bool allowNil, bool reuseStrings,
+		OsiStringArena * strings)
 	{
 		arg.TypeId = osiType;
 		auto type = lua_type(L, i);
@@ -171,9 +176,9 @@ namespace dse::esv::lua
 		case ValueType::SplineGuid:
 		case ValueType::LevelTemplateGuid:
 			if (reuseStrings) {
-				arg.String = LuaToString(L, i, type, const_cast<char*>(arg.String));
+				arg.String = LuaToString(L, i, type, const_cast<char*>(arg.String), nullptr);
 			} else {
-				arg.String = LuaToString(L, i, type, nullptr);
+				arg.String = LuaToString(L, i, type, nullptr, strings);
 			}
 			break;
 
@@ -286,6 +291,58 @@ namespace dse::esv::lua
 		return *func;
 	};
 
+	namespace
+	{
+		inline int HexDigitValue(char c)
+		{
+			if (c >= '0' && c <= '9') return c - '0';
+			c |= 0x20;
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			return -1;
+		}
+	}
+
+	bool ParseOsiGuid(char const* str, OsiGuidValue& guid)
+	{
+		guid.Valid = false;
+		if (str == nullptr) return false;
+
+		auto len = strlen(str);
+		if (len < 36) return false;
+
+		auto p = str + len - 36;
+		uint64_t val[2]{ 0, 0 };
+		unsigned digits{ 0 };
+		for (unsigned i = 0; i < 36; i++) {
+			if (i == 8 || i == 13 || i == 18 || i == 23) {
+				if (p[i] != '-') return false;
+				continue;
+			}
+
+			auto digit = HexDigitValue(p[i]);
+			if (digit < 0) return false;
+
+			auto& v = val[digits++ / 16];
+			v = (v << 4) | (uint64_t)digit;
+		}
+
+		guid.Value.Val[0] = val[0];
+		guid.Value.Val[1] = val[1];
+		guid.Valid = true;
+		return true;
+	}
+
+	bool OsiGuidStringsEqual(char const* a, OsiGuidValue const* parsedA, char const* b, OsiGuidValue const* parsedB)
+	{
+		if (parsedA && parsedB && parsedA->Valid && parsedB->Valid) {
+			return parsedA->Value == parsedB->Value;
+		}
+
+		auto lenA = strlen(a);
+		auto lenB = strlen(b);
+		return lenA >= 36 && lenB >= 36 && _stricmp(&a[lenA - 36], &b[lenB - 36]) == 0;
+	}
+
 
 	bool OsiFunction::Bind(Function const * func, ServerState & state)
 	{
@@ -375,6 +432,48 @@ namespace dse::esv::lua
 		}
 	}
 
+	int OsiFunction::LuaBatch(lua_State * L)
+	{
+		if (function_ == nullptr) {
+			return luaL_error(L, "Attempted to call an unbound Osiris function");
+		}
+
+		if (state_->RestrictionFlags & State::RestrictOsiris) {
+			return luaL_error(L, "Attempted to call Osiris function in restricted context");
+		}
+
+		luaL_checktype(L, 2, LUA_TTABLE);
+		auto numTuples = (uint32_t)lua_rawlen(L, 2);
+		if (numTuples == 0) {
+			return 0;
+		}
+
+		switch (function_->Type) {
+		case FunctionType::Call:
+			OsiBatchCall(L, numTuples);
+			return 0;
+
+		case FunctionType::Event:
+		case FunctionType::Proc:
+			OsiBatchInsert(L, numTuples);
+			return 0;
+
+		case FunctionType::Database:
+		{
+			auto node = function_->Node.Get();
+			if (node && node->IsDataNode()) {
+				OsiBatchInsert(L, numTuples);
+				return 0;
+			} else {
+				return luaL_error(L, "Batch calls are not supported for queries");
+			}
+		}
+
+		default:
+			return luaL_error(L, "Batch calls are not supported for functions of type %d", function_->Type);
+		}
+	}
+
 	int OsiFunction::LuaGet(lua_State * L)
 	{
 		if (!IsBound()) {
@@ -394,16 +493,39 @@ namespace dse::esv::lua
 			return luaL_error(L, "Attempted to read Osiris database in restricted context");
 		}
 
+		auto& indexes = state_->Osiris().GetDatabaseIndexes();
 		auto db = function_->Node.Get()->Database.Get();
-		
-
-		auto head = db->Facts.Head;
-		auto current = head->Next;
+		auto dbIndex = indexes.FindIndex(db, L, 2);
+		auto facts = dbIndex ? dbIndex->Lookup(L, 2) : std::nullopt;
 
 		lua_newtable(L);
 		auto index = 1;
+		if (facts) {
+			// Facts in the same bucket may only share a hash with the query, so they're still matched
+			for (auto it = facts->first; it != facts->second; ++it) {
+				if (MatchTuple(L, 2, it->second->Item)) {
+					push(L, index++);
+					ConstructTuple(L, it->second->Item);
+					lua_settable(L, -3);
+				}
+			}
+
+			return 1;
+		}
+
+		// Bound GUID arguments are parsed once and compared against the cached binary GUIDs of facts
+		auto guidCache = indexes.GetGuidCache(function_, L, 2);
+		Vector<OsiGuidValue> queryGuids;
+		if (guidCache) {
+			guidCache->ParseQuery(L, 2, queryGuids);
+		}
+
+		auto head = db->Facts.Head;
+		auto current = head->Next;
+		uint32_t position{ 0 };
 		while (current != head) {
-			if (MatchTuple(L, 2, current->Item)) {
+			auto factGuids = guidCache ? guidCache->GetRow(position++, current) : nullptr;
+			if (MatchTuple(L, 2, current->Item, guidCache, queryGuids.data(), factGuids)) {
 				push(L, index++);
 				ConstructTuple(L, current->Item);
 				lua_settable(L, -3);
@@ -461,7 +583,47 @@ namespace dse::esv::lua
 		}
 	}
 
-	bool OsiFunction::MatchTuple(lua_State * L, int firstIndex, TupleVec const & tuple)
+	int OsiFunction::LuaCreateIndex(lua_State * L)
+	{
+		if (!IsBound()) {
+			return luaL_error(L, "Attempted to index an unbound Osiris database");
+		}
+
+		if (!IsDB()) {
+			return luaL_error(L, "Attempted to index function that's not a database");
+		}
+
+		if (state_->RestrictionFlags & State::RestrictOsiris) {
+			return luaL_error(L, "Attempted to index Osiris database in restricted context");
+		}
+
+		// Columns passed as true are indexed
+		int numArgs = lua_gettop(L) - 1;
+		Vector<uint32_t> columns;
+		auto argType = function_->Signature->Params->Params.Head->Next;
+		for (int i = 0; i < numArgs; i++) {
+			if (lua_toboolean(L, i + 2)) {
+				if (!OsiDatabaseIndex::IsIndexableType((ValueType)argType->Item.Type)) {
+					return luaL_error(L, "Column %d of database '%s' cannot be indexed; only integer, string and GUID columns are supported",
+						i + 1, function_->Signature->Name);
+				}
+
+				columns.push_back((uint32_t)i);
+			}
+
+			argType = argType->Next;
+		}
+
+		if (columns.empty()) {
+			return luaL_error(L, "No columns were selected for indexing");
+		}
+
+		state_->Osiris().GetDatabaseIndexes().CreateIndex(function_, columns);
+		return 0;
+	}
+
+	bool OsiFunction::MatchTuple(lua_State * L, int firstIndex, TupleVec const & tuple, OsiFactGuidCache const * guidCache,
+		OsiGuidValue const * queryGuids, OsiGuidValue const * factGuids)
 	{
 		for (auto i = 0; i < tuple.Size; i++) {
 			if (!lua_isnil(L, firstIndex + i)) {
@@ -504,9 +666,10 @@ namespace dse::esv::lua
 					auto str = lua_tostring(L, firstIndex + i);
 					if (!str) return false;
 
-					auto len = strlen(str);
-					auto valueLen = strlen(v.Value.Val.String);
-					if (valueLen < 36 || len < 36 || _stricmp(&v.Value.Val.String[valueLen - 36], &str[len - 36]) != 0) {
+					auto slot = (guidCache && factGuids) ? guidCache->GetSlot(i) : -1;
+					auto factGuid = (slot >= 0) ? &factGuids[slot] : nullptr;
+					auto queryGuid = (slot >= 0) ? &queryGuids[slot] : nullptr;
+					if (!OsiGuidStringsEqual(v.Value.Val.String, factGuid, str, queryGuid)) {
 						return false;
 					}
 					break;
@@ -542,19 +705,109 @@ namespace dse::esv::lua
 		}
 
 		OsiArgumentListPin<OsiArgumentDesc> args(state_->Osiris().GetArgumentDescPool(), (uint32_t)funcArgs);
+		OsiStringArenaPin strings(state_->Osiris().GetStringArena());
 		auto argType = function_->Signature->Params->Params.Head->Next;
 		for (uint32_t i = 0; i < funcArgs; i++) {
 			auto arg = args.Args() + i;
 			if (i > 0) {
 				args.Args()[i - 1].NextParam = arg;
 			}
-			LuaToOsi(L, i + 2, arg->Value, (ValueType)argType->Item.Type);
+			LuaToOsi(L, i + 2, arg->Value, (ValueType)argType->Item.Type, false, false, strings.Arena());
 			argType = argType->Next;
 		}
 
 		gExtender->GetServer().Osiris().GetWrappers().Call.CallWithHooks(function_->GetHandle(), funcArgs == 0 ? nullptr : args.Args());
 	}
 
+	int OsiFunction::PushBatchTuple(lua_State * L, uint32_t index, uint32_t numArgs)
+	{
+		lua_rawgeti(L, 2, index);
+		if (lua_type(L, -1) != LUA_TTABLE) {
+			luaL_error(L, "Batch entry %d is not a table", index);
+		}
+
+		auto tupleSize = (uint32_t)lua_rawlen(L, -1);
+		if (tupleSize != numArgs) {
+			luaL_error(L, "Incorrect number of arguments in batch entry %d for '%s'; expected %d, got %d",
+				index, function_->Signature->Name, numArgs, tupleSize);
+		}
+
+		auto tupleIndex = lua_gettop(L);
+		for (uint32_t i = 1; i <= numArgs; i++) {
+			lua_rawgeti(L, tupleIndex, i);
+		}
+
+		return tupleIndex + 1;
+	}
+
+	void OsiFunction::OsiBatchCall(lua_State * L, uint32_t numTuples)
+	{
+		auto funcArgs = function_->Signature->Params->Params.Size;
+		luaL_checkstack(L, (int)funcArgs + 1, "Not enough stack space for batch arguments");
+
+		// The argument chain is built once and its values are overwritten for each entry
+		OsiArgumentListPin<OsiArgumentDesc> args(state_->Osiris().GetArgumentDescPool(), (uint32_t)funcArgs);
+		for (uint32_t i = 1; i < funcArgs; i++) {
+			args.Args()[i - 1].NextParam = args.Args() + i;
+		}
+
+		auto& call = gExtender->GetServer().Osiris().GetWrappers().Call;
+		auto handle = function_->GetHandle();
+		auto top = lua_gettop(L);
+		for (uint32_t tuple = 1; tuple <= numTuples; tuple++) {
+			OsiStringArenaPin strings(state_->Osiris().GetStringArena());
+			auto firstArg = PushBatchTuple(L, tuple, funcArgs);
+			auto argType = function_->Signature->Params->Params.Head->Next;
+			for (uint32_t i = 0; i < funcArgs; i++) {
+				LuaToOsi(L, firstArg + i, args.Args()[i].Value, (ValueType)argType->Item.Type, false, false, strings.Arena());
+				argType = argType->Next;
+			}
+
+			lua_settop(L, top);
+			call.CallWithHooks(handle, funcArgs == 0 ? nullptr : args.Args());
+		}
+	}
+
+	void OsiFunction::OsiBatchInsert(lua_State * L, uint32_t numTuples)
+	{
+		auto funcArgs = function_->Signature->Params->Params.Size;
+		if (function_->Node.Id == 0) {
+			luaL_error(L, "Function has no node");
+		}
+
+		luaL_checkstack(L, (int)funcArgs + 1, "Not enough stack space for batch arguments");
+
+		OsiArgumentListPin<TypedValue> tvs(state_->Osiris().GetTypedValuePool(), (uint32_t)funcArgs);
+		OsiArgumentListPin<ListNode<TypedValue *>> nodes(state_->Osiris().GetTypedValueNodePool(), (uint32_t)funcArgs + 1);
+
+		// The tuple is built once and its values are overwritten for each entry
+		TuplePtrLL tuple;
+		auto & args = tuple.Items;
+		args.Init(nodes.Args());
+
+		auto prev = args.Head;
+		for (uint32_t i = 0; i < funcArgs; i++) {
+			auto node = nodes.Args() + i + 1;
+			args.Insert(tvs.Args() + i, node, prev);
+			prev = node;
+		}
+
+		auto node = function_->Node.Get();
+		auto top = lua_gettop(L);
+		for (uint32_t entry = 1; entry <= numTuples; entry++) {
+			auto firstArg = PushBatchTuple(L, entry, funcArgs);
+			auto argType = function_->Signature->Params->Params.Head->Next;
+			for (uint32_t i = 0; i < funcArgs; i++) {
+				// Inserted facts keep the string pointers of the tuple, so strings are heap-allocated here
+				LuaToOsi(L, firstArg + i, tvs.Args()[i], (ValueType)argType->Item.Type, false, nullptr);
+				argType = argType->Next;
+			}
+
+			lua_settop(L, top);
+			node->InsertTuple(&tuple);
+		}
+	}
+
 	void OsiFunction::OsiDeferredNotification(lua_State * L)
 	{
 		auto funcArgs = function_->Signature->Params->Params.Size;
@@ -607,6 +860,9 @@ namespace dse::esv::lua
 
 		OsiArgumentListPin<TypedValue> tvs(state_->Osiris().GetTypedValuePool(), (uint32_t)funcArgs);
 		OsiArgumentListPin<ListNode<TypedValue *>> nodes(state_->Osiris().GetTypedValueNodePool(), (uint32_t)funcArgs + 1);
+		OsiStringArenaPin strings(state_->Osiris().GetStringArena());
+		// Inserted facts keep the string pointers of the tuple, so they can't live in the arena
+		auto stringArena = deleteTuple ? strings.Arena() : nullptr;
 
 		TuplePtrLL tuple;
 		auto & args = tuple.Items;
@@ -616,7 +872,7 @@ namespace dse::esv::lua
 		auto prev = args.Head;
 		for (uint32_t i = 0; i < funcArgs; i++) {
 			auto tv = tvs.Args() + i;
-			LuaToOsi(L, i + 2, *tv, (ValueType)argType->Item.Type, deleteTuple);
+			LuaToOsi(L, i + 2, *tv, (ValueType)argType->Item.Type, deleteTuple, stringArena);
 			auto node = nodes.Args() + i + 1;
 			args.Insert(tv, node, prev);
 			prev = node;
@@ -644,6 +900,7 @@ namespace dse::esv::lua
 		}
 
 		OsiArgumentListPin<OsiArgumentDesc> args(state_->Osiris().GetArgumentDescPool(), (uint32_t)numParams);
+		OsiStringArenaPin strings(state_->Osiris().GetStringArena());
 		auto argType = function_->Signature->Params->Params.Head->Next;
 		uint32_t inputArg = 2;
 		for (uint32_t i = 0; i < numParams; i++) {
@@ -655,7 +912,7 @@ namespace dse::esv::lua
 			if (function_->Signature->OutParamList.isOutParam(i)) {
 				arg->Value.TypeId = (ValueType)argType->Item.Type;
 			} else {
-				LuaToOsi(L, inputArg++, arg->Value, (ValueType)argType->Item.Type);
+				LuaToOsi(L, inputArg++, arg->Value, (ValueType)argType->Item.Type, false, false, strings.Arena());
 			}
 
 			argType = argType->Next;
@@ -695,6 +952,10 @@ namespace dse::esv::lua
 		}
 
 		OsiArgumentListPin<ListNode<TupleLL::Item>> nodes(state_->Osiris().GetTupleNodePool(), (uint32_t)numParams + 1);
+		OsiStringArenaPin strings(state_->Osiris().GetStringArena());
+		// User query rules may insert the bound arguments into databases, and inserted facts keep
+		// the string pointers of the tuple; only built-in sys queries can use the arena
+		auto stringArena = (function_->Type == FunctionType::SysQuery) ? strings.Arena() : nullptr;
 
 		VirtTupleLL tuple;
 		
@@ -709,7 +970,7 @@ namespace dse::esv::lua
 			args.Insert(node, prev);
 			node->Item.Index = i;
 			if (!function_->Signature->OutParamList.isOutParam(i)) {
-				LuaToOsi(L, inputArgIndex + 2, node->Item.Value, (ValueType)argType->Item.Type);
+				LuaToOsi(L, inputArgIndex + 2, node->Item.Value, (ValueType)argType->Item.Type, false, stringArena);
 				inputArgIndex++;
 			} else {
 				node->Item.Value.VMT = gExtender->GetServer().Osiris().GetGlobals().TypedValueVMT;
@@ -771,6 +1032,12 @@ namespace dse::esv::lua
 		lua_pushcfunction(L, &LuaDeferredNotification);
 		lua_setfield(L, -2, "Defer");
 
+		lua_pushcfunction(L, &LuaCreateIndex);
+		lua_setfield(L, -2, "CreateIndex");
+
+		lua_pushcfunction(L, &LuaBatch);
+		lua_setfield(L, -2, "Batch");
+
 		lua_setfield(L, -2, "__index");
 	}
 
@@ -868,6 +1135,53 @@ namespace dse::esv::lua
 		return func->LuaDeferredNotification(L);
 	}
 
+	int OsiFunctionNameProxy::LuaCreateIndex(lua_State * L)
+	{
+		auto self = OsiFunctionNameProxy::CheckUserData(L, 1);
+		if (!self->BeforeCall(L)) return 1;
+
+		auto arity = (uint32_t)lua_gettop(L) - 1;
+
+		auto func = self->TryGetFunction(arity);
+		if (func == nullptr) {
+			return luaL_error(L, "No database named '%s(%d)' exists", self->name_.c_str(), arity);
+		}
+
+		if (!func->IsDB()) {
+			return luaL_error(L, "Function '%s(%d)' is not a database", self->name_.c_str(), arity);
+		}
+
+		return func->LuaCreateIndex(L);
+	}
+
+	int OsiFunctionNameProxy::LuaBatch(lua_State * L)
+	{
+		auto self = OsiFunctionNameProxy::CheckUserData(L, 1);
+		if (!self->BeforeCall(L)) return 1;
+
+		luaL_checktype(L, 2, LUA_TTABLE);
+		if (lua_rawlen(L, 2) == 0) {
+			return 0;
+		}
+
+		// All entries must have the same number of arguments, so the function is resolved using the first one
+		lua_rawgeti(L, 2, 1);
+		if (lua_type(L, -1) != LUA_TTABLE) {
+			return luaL_error(L, "Batch entry 1 is not a table");
+		}
+
+		auto arity = (uint32_t)lua_rawlen(L, -1);
+		lua_pop(L, 1);
+
+		auto func = self->TryGetFunction(arity);
+		if (func == nullptr) {
+			return luaL_error(L, "No function named '%s' exists that can be called with %d parameters.",
+				self->name_.c_str(), arity);
+		}
+
+		return func->LuaBatch(L);
+	}
+
 	OsiFunction * OsiFunctionNameProxy::TryGetFunction(uint32_t arity)
 	{
 		if (functions_.size() > arity
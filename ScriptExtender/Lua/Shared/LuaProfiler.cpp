@@ -0,0 +1,178 @@
+#include <stdafx.h>
+#include <Lua/Shared/LuaProfiler.h>
+#include <Lua/Shared/LuaBinding.h>
+#include <ScriptHelpers.h>
+
+BEGIN_NS(lua)
+
+bool SamplingProfiler::Start(lua_State* L, uint32_t intervalUs, std::size_t maxStacks)
+{
+	if (running_) {
+		OsiErrorS("Profiler is already running");
+		return false;
+	}
+
+	auto hook = lua_gethook(L);
+	if (hook != nullptr && hook != &Hook) {
+		OsiErrorS("Cannot start profiler while another Lua hook (eg. the Lua debugger) is active");
+		return false;
+	}
+
+	intervalUs_ = std::max(intervalUs, 1u);
+	maxStacks_ = maxStacks;
+	lastSample_ = Clock::now();
+	running_ = true;
+	lua_sethook(L, &Hook, LUA_MASKCOUNT | LUA_MASKCALL | LUA_MASKRET, HookInstructionCount);
+	return true;
+}
+
+void SamplingProfiler::Stop(lua_State* L)
+{
+	if (!running_) return;
+
+	running_ = false;
+	if (lua_gethook(L) == &Hook) {
+		lua_sethook(L, nullptr, 0, 0);
+	}
+}
+
+void SamplingProfiler::Reset()
+{
+	stacks_.clear();
+	numSamples_ = 0;
+	numDroppedSamples_ = 0;
+}
+
+void SamplingProfiler::Hook(lua_State* L, lua_Debug* ar)
+{
+	auto& profiler = State::FromLua(L)->GetProfiler();
+	if (!profiler.running_) {
+		// Coroutines created while profiling inherit the hook; remove it lazily
+		lua_sethook(L, nullptr, 0, 0);
+		return;
+	}
+
+	switch (ar->event) {
+	case LUA_HOOKCALL:
+	case LUA_HOOKTAILCALL:
+		profiler.OnEnter(L);
+		break;
+
+	default:
+		profiler.Sample(L);
+		break;
+	}
+}
+
+void SamplingProfiler::OnEnter(lua_State* L)
+{
+	// Only calls made directly by the engine have no caller frame; coroutines are resumed from Lua,
+	// so their outermost frame doesn't restart the clock
+	lua_Debug caller;
+	if (lua_getstack(L, 1, &caller)) return;
+
+	if (lua_pushthread(L)) {
+		lastSample_ = Clock::now();
+	}
+	lua_pop(L, 1);
+}
+
+void SamplingProfiler::AppendFrameName(lua_Debug& ar, STDString& name)
+{
+	name.clear();
+	if (*ar.what == 'C') {
+		name = ar.name ? ar.name : "[C]";
+		return;
+	}
+
+	auto source = ar.source;
+	if (*source == '@' || *source == '=') source++;
+
+	if (ar.name) {
+		name += ar.name;
+		name += " (";
+	}
+
+	name += source;
+	if (*ar.what != 'm') {
+		name += ":";
+		name += std::to_string(ar.linedefined).c_str();
+	}
+
+	if (ar.name) {
+		name += ")";
+	}
+
+	// Semicolons are used as frame separators in the folded format
+	std::replace(name.begin(), name.end(), ';', ',');
+}
+
+void SamplingProfiler::Sample(lua_State* L)
+{
+	auto now = Clock::now();
+	auto interval = std::chrono::microseconds(intervalUs_);
+	auto elapsed = now - lastSample_;
+	if (elapsed < interval) return;
+
+	// Attribute every interval that passed since the last sample to the current stack
+	uint64_t weight = std::min<uint64_t>(elapsed / interval, MaxSampleWeight);
+	lastSample_ = now;
+
+	lua_Debug ar;
+	unsigned depth = 0;
+	while (depth < MaxStackDepth && lua_getstack(L, depth, &ar)) {
+		lua_getinfo(L, "Sn", &ar);
+		if (frames_.size() <= depth) {
+			frames_.resize(depth + 1);
+		}
+
+		AppendFrameName(ar, frames_[depth]);
+		depth++;
+	}
+
+	stackBuf_.clear();
+	if (depth == MaxStackDepth && lua_getstack(L, depth, &ar)) {
+		stackBuf_ = "[truncated]";
+	}
+
+	// Folded stacks start from the outermost frame
+	for (unsigned i = depth; i > 0; i--) {
+		if (!stackBuf_.empty()) {
+			stackBuf_ += ';';
+		}
+		stackBuf_ += frames_[i - 1];
+	}
+
+	auto it = stacks_.find(stackBuf_);
+	if (it != stacks_.end()) {
+		it->second += weight;
+	} else if (stacks_.size() < maxStacks_) {
+		stacks_.insert(std::make_pair(stackBuf_, weight));
+	} else {
+		numDroppedSamples_ += weight;
+		return;
+	}
+
+	numSamples_ += weight;
+}
+
+STDString SamplingProfiler::GetFoldedStacks() const
+{
+	STDString folded;
+	for (auto const& stack : stacks_) {
+		folded += stack.first;
+		folded += ' ';
+		folded += std::to_string(stack.second).c_str();
+		folded += '\n';
+	}
+
+	return folded;
+}
+
+bool SamplingProfiler::SaveFoldedStacks(std::string_view path) const
+{
+	auto folded = GetFoldedStacks();
+	return script::SaveExternalFile(path, PathRootType::GameStorage, folded);
+}
+
+END_NS()
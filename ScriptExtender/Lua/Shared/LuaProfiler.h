@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Lua/Shared/LuaHelpers.h>
+#include <chrono>
+
+BEGIN_NS(lua)
+
+// Sampling profiler for a Lua state.
+// A count hook fires every few hundred instructions and captures the call stack when the sampling
+// interval has elapsed. The sample is weighted by the number of intervals elapsed since the previous
+// one, so stacks that run long stretches between hook firings aren't undercounted. Return hooks
+// check the timer as well, so time spent in a slow C function is charged to that function.
+// Time outside of Lua isn't counted: the sampling clock restarts whenever the engine enters Lua.
+// Stacks are aggregated in memory and can be written in the folded stack format
+// ("root;caller;callee count") consumed by flamegraph tools.
+class SamplingProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Number of VM instructions between two checks of the sampling timer
+	static constexpr int HookInstructionCount = 500;
+	static constexpr unsigned MaxStackDepth = 64;
+	static constexpr uint32_t DefaultIntervalUs = 1000;
+	// Upper bound on the number of distinct stacks kept in memory
+	static constexpr std::size_t DefaultMaxStacks = 20000;
+	// Upper bound on the weight of a single sample
+	static constexpr uint64_t MaxSampleWeight = 100;
+
+	bool Start(lua_State* L, uint32_t intervalUs = DefaultIntervalUs, std::size_t maxStacks = DefaultMaxStacks);
+	void Stop(lua_State* L);
+
+	inline bool IsRunning() const
+	{
+		return running_;
+	}
+
+	inline uint64_t NumSamples() const
+	{
+		return numSamples_;
+	}
+
+	inline uint64_t NumDroppedSamples() const
+	{
+		return numDroppedSamples_;
+	}
+
+	inline std::size_t NumStacks() const
+	{
+		return stacks_.size();
+	}
+
+	STDString GetFoldedStacks() const;
+	bool SaveFoldedStacks(std::string_view path) const;
+	void Reset();
+
+private:
+	bool running_{ false };
+	uint32_t intervalUs_{ DefaultIntervalUs };
+	std::size_t maxStacks_{ DefaultMaxStacks };
+	Clock::time_point lastSample_;
+	uint64_t numSamples_{ 0 };
+	uint64_t numDroppedSamples_{ 0 };
+	std::unordered_map<STDString, uint64_t> stacks_;
+	// Reused between samples to avoid allocations
+	STDString stackBuf_;
+	std::vector<STDString> frames_;
+
+	static void Hook(lua_State* L, lua_Debug* ar);
+	void OnEnter(lua_State* L);
+	void Sample(lua_State* L);
+	void AppendFrameName(lua_Debug& ar, STDString& name);
+};
+
+END_NS()
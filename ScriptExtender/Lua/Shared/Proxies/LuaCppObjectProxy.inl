@@ -8,31 +8,25 @@ struct CppObjectProxyHelpers
 {
 	static int Next(lua_State* L, GenericPropertyMap const& pm, void* object, LifetimeHandle const& lifetime, FixedString const& key)
 	{
-		if (!key) {
-			if (!pm.Properties.empty()) {
-				StackCheck _(L, 2);
-				auto it = pm.Properties.begin();
-				push(L, it->first);
-				if (pm.GetRawProperty(L, lifetime, object, it->first) != PropertyOperationResult::Success) {
-					push(L, nullptr);
-				}
-
-				return 2;
+		uint32_t index = 0;
+		if (key) {
+			auto prop = pm.FindProperty(key);
+			if (prop == nullptr) {
+				return 0;
 			}
-		} else {
-			auto it = pm.Properties.find(key);
-			if (it != pm.Properties.end()) {
-				++it;
-				if (it != pm.Properties.end()) {
-					StackCheck _(L, 2);
-					push(L, it->first);
-					if (pm.GetRawProperty(L, lifetime, object, it->first) != PropertyOperationResult::Success) {
-						push(L, nullptr);
-					}
-
-					return 2;
-				}
+
+			index = prop->Index + 1;
+		}
+
+		if (index < pm.Properties.size()) {
+			StackCheck _(L, 2);
+			auto const& prop = pm.Properties[index];
+			push(L, prop.Name);
+			if (prop.Get(L, lifetime, object, prop.Offset, prop.Flag) != PropertyOperationResult::Success) {
+				push(L, nullptr);
 			}
+
+			return 2;
 		}
 
 		return 0;
@@ -2,6 +2,7 @@
 
 #include <Lua/Shared/LuaHelpers.h>
 #include <Lua/Shared/LuaLifetime.h>
+#include <Lua/Shared/LuaEventStats.h>
 #include <Lua/Shared/Proxies/LuaUserdata.h>
 
 BEGIN_NS(lua)
@@ -19,4 +20,118 @@ struct EventBase
 
 struct EmptyEvent : public EventBase {};
 
+// Subscriber list of an engine event (Ext.Events.X).
+// Handlers are stored in slots; subscriber IDs returned to Lua encode the slot and a salt,
+// so unsubscribing doesn't need to search for the handler.
+// Slots are referenced from per-priority buckets that are walked in descending priority order.
+class SubscribableEvent : Noncopyable<SubscribableEvent>
+{
+public:
+	static constexpr int32_t DefaultPriority = 100;
+
+	SubscribableEvent(FixedString const& name);
+
+	inline FixedString const& GetName() const
+	{
+		return name_;
+	}
+
+	inline bool HasSubscribers() const
+	{
+		return numSubscribers_ > 0;
+	}
+
+	inline uint32_t NumSubscribers() const
+	{
+		return numSubscribers_;
+	}
+
+	// Adds the function at the specified stack index as a subscriber
+	uint64_t Subscribe(lua_State* L, int handlerIndex, int32_t priority, bool once);
+	bool Unsubscribe(uint64_t subscriberId);
+	// Calls subscribers with the event object at the specified stack index
+	void Throw(lua_State* L, int eventIndex, EventBase* evt);
+	void Clear();
+
+	// Enables recording of dispatch and handler latencies
+	void SetProfiling(bool enabled);
+	void ResetStats();
+
+	inline LatencyHistogram const* GetLatencyStats() const
+	{
+		return latency_.get();
+	}
+
+	inline auto const& GetHandlerStats() const
+	{
+		return handlerStats_;
+	}
+
+private:
+	struct Subscriber
+	{
+		RegistryEntry Handler;
+		int32_t Priority{ 0 };
+		uint32_t Salt{ 0 };
+		bool Once{ false };
+		bool Active{ false };
+		// Source location of the handler function, used for attributing latency stats
+		STDString Source;
+		EventHandlerStats* Stats{ nullptr };
+	};
+
+	struct PriorityBucket
+	{
+		int32_t Priority;
+		std::vector<uint32_t> Slots;
+	};
+
+	FixedString name_;
+	std::vector<Subscriber> subscribers_;
+	std::vector<uint32_t> freeSlots_;
+	// Sorted by descending priority
+	std::vector<PriorityBucket> buckets_;
+	// Subscribers added while the event was being dispatched
+	std::vector<uint32_t> pendingSlots_;
+	uint32_t numSubscribers_{ 0 };
+	uint32_t numInactiveSlots_{ 0 };
+	uint32_t enterCount_{ 0 };
+
+	bool profiling_{ false };
+	std::unique_ptr<LatencyHistogram> latency_;
+	std::unordered_map<STDString, std::unique_ptr<EventHandlerStats>> handlerStats_;
+
+	EventHandlerStats* GetOrCreateHandlerStats(Subscriber& sub);
+	void AddToBucket(uint32_t slot);
+	void Deactivate(Subscriber& sub);
+	void FinishDispatch();
+	void Compact();
+	bool IsStopped(lua_State* L, int eventIndex, EventBase* evt);
+};
+
+// Lua handle for a SubscribableEvent; the event itself is owned by the Lua state.
+class SubscribableEventProxy : public Userdata<SubscribableEventProxy>
+{
+public:
+	static char const* const MetatableName;
+
+	static void PopulateMetatable(lua_State* L);
+
+	inline SubscribableEventProxy(SubscribableEvent* event)
+		: event_(event)
+	{}
+
+	inline SubscribableEvent* Get() const
+	{
+		return event_;
+	}
+
+private:
+	SubscribableEvent* event_;
+
+	static int Subscribe(lua_State* L);
+	static int Unsubscribe(lua_State* L);
+	static int Throw(lua_State* L);
+};
+
 END_NS()
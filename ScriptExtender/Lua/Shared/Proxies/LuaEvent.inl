@@ -1,4 +1,5 @@
 #include <Lua/Shared/Proxies/LuaEvent.h>
+#include <Extender/ScriptExtender.h>
 
 BEGIN_NS(lua)
 
@@ -16,4 +17,341 @@ void EventBase::PreventAction()
 	}
 }
 
+SubscribableEvent::SubscribableEvent(FixedString const& name)
+	: name_(name)
+{}
+
+uint64_t SubscribableEvent::Subscribe(lua_State* L, int handlerIndex, int32_t priority, bool once)
+{
+	uint32_t slot;
+	if (!freeSlots_.empty()) {
+		slot = freeSlots_.back();
+		freeSlots_.pop_back();
+	} else {
+		slot = (uint32_t)subscribers_.size();
+		subscribers_.emplace_back();
+	}
+
+	auto& sub = subscribers_[slot];
+	sub.Handler = RegistryEntry(L, handlerIndex);
+	sub.Priority = priority;
+	sub.Once = once;
+	sub.Active = true;
+	sub.Stats = nullptr;
+	numSubscribers_++;
+
+	lua_Debug ar;
+	lua_pushvalue(L, handlerIndex);
+	if (lua_getinfo(L, ">S", &ar)) {
+		auto source = ar.source;
+		if (*source == '@' || *source == '=') source++;
+		sub.Source = source;
+		sub.Source += ":";
+		sub.Source += std::to_string(ar.linedefined).c_str();
+	} else {
+		sub.Source = "(unknown)";
+	}
+
+	// Bucket arrays must not change while they're being iterated
+	if (enterCount_ > 0) {
+		pendingSlots_.push_back(slot);
+	} else {
+		AddToBucket(slot);
+	}
+
+	return ((uint64_t)sub.Salt << 32) | slot;
+}
+
+void SubscribableEvent::AddToBucket(uint32_t slot)
+{
+	auto priority = subscribers_[slot].Priority;
+	auto it = std::lower_bound(buckets_.begin(), buckets_.end(), priority, [](PriorityBucket const& bucket, int32_t priority) {
+		return bucket.Priority > priority;
+	});
+
+	if (it == buckets_.end() || it->Priority != priority) {
+		it = buckets_.insert(it, PriorityBucket{ priority });
+	}
+
+	it->Slots.push_back(slot);
+}
+
+bool SubscribableEvent::Unsubscribe(uint64_t subscriberId)
+{
+	auto slot = (uint32_t)(subscriberId & 0xffffffffull);
+	auto salt = (uint32_t)(subscriberId >> 32);
+	if (slot >= subscribers_.size()) {
+		return false;
+	}
+
+	auto& sub = subscribers_[slot];
+	if (!sub.Active || sub.Salt != salt) {
+		return false;
+	}
+
+	Deactivate(sub);
+	if (enterCount_ == 0 && numInactiveSlots_ > numSubscribers_) {
+		Compact();
+	}
+
+	return true;
+}
+
+void SubscribableEvent::Deactivate(Subscriber& sub)
+{
+	// Slot stays allocated until the next compaction, as it may still be referenced from a bucket
+	sub.Active = false;
+	sub.Handler = RegistryEntry();
+	numSubscribers_--;
+	numInactiveSlots_++;
+}
+
+void SubscribableEvent::Compact()
+{
+	for (auto& bucket : buckets_) {
+		auto end = std::remove_if(bucket.Slots.begin(), bucket.Slots.end(), [this](uint32_t slot) {
+			return !subscribers_[slot].Active;
+		});
+		bucket.Slots.erase(end, bucket.Slots.end());
+	}
+
+	auto end = std::remove_if(buckets_.begin(), buckets_.end(), [](PriorityBucket const& bucket) {
+		return bucket.Slots.empty();
+	});
+	buckets_.erase(end, buckets_.end());
+
+	freeSlots_.clear();
+	for (uint32_t slot = 0; slot < subscribers_.size(); slot++) {
+		auto& sub = subscribers_[slot];
+		if (!sub.Active) {
+			// Invalidate IDs that referenced the previous subscriber of this slot
+			sub.Salt++;
+			freeSlots_.push_back(slot);
+		}
+	}
+
+	numInactiveSlots_ = 0;
+}
+
+bool SubscribableEvent::IsStopped(lua_State* L, int eventIndex, EventBase* evt)
+{
+	if (evt != nullptr) {
+		return evt->Stopped;
+	}
+
+	// Event thrown from Lua, may be any object with a Stopped field
+	lua_getfield(L, eventIndex, "Stopped");
+	auto stopped = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	return stopped;
+}
+
+void SubscribableEvent::SetProfiling(bool enabled)
+{
+	profiling_ = enabled;
+	if (enabled && !latency_) {
+		latency_ = std::make_unique<LatencyHistogram>();
+	}
+}
+
+void SubscribableEvent::ResetStats()
+{
+	// Stats objects are kept alive, as a dispatch may be in progress
+	if (latency_) {
+		latency_->Reset();
+	}
+
+	for (auto& stats : handlerStats_) {
+		stats.second->Latency.Reset();
+	}
+}
+
+EventHandlerStats* SubscribableEvent::GetOrCreateHandlerStats(Subscriber& sub)
+{
+	if (sub.Stats == nullptr) {
+		auto it = handlerStats_.find(sub.Source);
+		if (it == handlerStats_.end()) {
+			auto stats = std::make_unique<EventHandlerStats>();
+			stats->Source = sub.Source;
+			// Mod scripts are loaded as "<mod directory>/<path>", builtin scripts as "builtin://<path>"
+			if (sub.Source.starts_with("builtin://")) {
+				stats->Mod = "builtin";
+			} else {
+				stats->Mod = sub.Source.substr(0, sub.Source.find('/'));
+			}
+
+			it = handlerStats_.insert(std::make_pair(sub.Source, std::move(stats))).first;
+		}
+
+		sub.Stats = it->second.get();
+	}
+
+	return sub.Stats;
+}
+
+void SubscribableEvent::Throw(lua_State* L, int eventIndex, EventBase* evt)
+{
+	using Clock = std::chrono::steady_clock;
+
+	StackCheck _(L, 0);
+	eventIndex = lua_absindex(L, eventIndex);
+	enterCount_++;
+
+	// Checked once, in case a handler toggles profiling
+	auto profiling = profiling_;
+	Clock::time_point dispatchStart;
+	if (profiling) {
+		dispatchStart = Clock::now();
+	}
+
+	lua_pushcfunction(L, &TracebackHandler);
+	auto handlerIndex = lua_gettop(L);
+
+	for (std::size_t bucket = 0; bucket < buckets_.size(); bucket++) {
+		for (std::size_t i = 0; i < buckets_[bucket].Slots.size(); i++) {
+			auto slot = buckets_[bucket].Slots[i];
+			auto& sub = subscribers_[slot];
+			if (!sub.Active) {
+				continue;
+			}
+
+			if (IsStopped(L, eventIndex, evt)) {
+				goto done;
+			}
+
+			// Subscriber may be moved during the call, don't keep a reference to it
+			auto stats = profiling ? GetOrCreateHandlerStats(sub) : nullptr;
+			sub.Handler.Push();
+			if (sub.Once) {
+				Deactivate(sub);
+			}
+
+			lua_pushvalue(L, eventIndex);
+			Clock::time_point handlerStart;
+			if (stats) {
+				handlerStart = Clock::now();
+			}
+
+			auto status = lua_pcall(L, 1, 0, handlerIndex);
+			if (stats) {
+				stats->Latency.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - handlerStart).count());
+			}
+
+			if (status != LUA_OK) { // stack: errmsg
+				STDString msg("Error while dispatching event ");
+				msg += name_.GetStringOrDefault();
+				msg += ": ";
+				msg += lua_tostring(L, -1);
+				gExtender->LogLuaError(msg);
+				lua_pop(L, 1);
+			}
+		}
+	}
+
+done:
+	lua_pop(L, 1);
+	if (profiling && latency_) {
+		latency_->Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - dispatchStart).count());
+	}
+
+	enterCount_--;
+	if (enterCount_ == 0) {
+		FinishDispatch();
+	}
+}
+
+void SubscribableEvent::FinishDispatch()
+{
+	for (auto slot : pendingSlots_) {
+		if (subscribers_[slot].Active) {
+			AddToBucket(slot);
+		}
+	}
+
+	pendingSlots_.clear();
+
+	if (numInactiveSlots_ > 0) {
+		Compact();
+	}
+}
+
+void SubscribableEvent::Clear()
+{
+	subscribers_.clear();
+	freeSlots_.clear();
+	buckets_.clear();
+	pendingSlots_.clear();
+	numSubscribers_ = 0;
+	numInactiveSlots_ = 0;
+}
+
+
+char const* const SubscribableEventProxy::MetatableName = "SubscribableEvent";
+
+int SubscribableEventProxy::Subscribe(lua_State* L)
+{
+	StackCheck _(L, 1);
+	auto self = CheckUserData(L, 1);
+	luaL_checktype(L, 2, LUA_TFUNCTION);
+
+	int32_t priority = SubscribableEvent::DefaultPriority;
+	bool once = false;
+	if (lua_type(L, 3) == LUA_TTABLE) {
+		lua_getfield(L, 3, "Priority");
+		if (lua_type(L, -1) != LUA_TNIL) {
+			priority = (int32_t)luaL_checknumber(L, -1);
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, 3, "Once");
+		once = lua_toboolean(L, -1);
+		lua_pop(L, 1);
+	}
+
+	auto id = self->event_->Subscribe(L, 2, priority, once);
+	push(L, (int64_t)id);
+	return 1;
+}
+
+int SubscribableEventProxy::Unsubscribe(lua_State* L)
+{
+	StackCheck _(L, 0);
+	auto self = CheckUserData(L, 1);
+	auto id = (uint64_t)luaL_checkinteger(L, 2);
+
+	if (!self->event_->Unsubscribe(id)) {
+		std::stringstream ss;
+		ss << "Attempted to remove subscriber ID " << id << " for event '" << self->event_->GetName().GetStringOrDefault()
+			<< "', but no such subscriber exists (maybe it was removed already?)";
+		gExtender->LogOsirisWarning(ss.str());
+	}
+
+	return 0;
+}
+
+int SubscribableEventProxy::Throw(lua_State* L)
+{
+	StackCheck _(L, 0);
+	auto self = CheckUserData(L, 1);
+	luaL_checkany(L, 2);
+	self->event_->Throw(L, 2, nullptr);
+	return 0;
+}
+
+void SubscribableEventProxy::PopulateMetatable(lua_State* L)
+{
+	lua_newtable(L);
+
+	lua_pushcfunction(L, &Subscribe);
+	lua_setfield(L, -2, "Subscribe");
+
+	lua_pushcfunction(L, &Unsubscribe);
+	lua_setfield(L, -2, "Unsubscribe");
+
+	lua_pushcfunction(L, &Throw);
+	lua_setfield(L, -2, "Throw");
+
+	lua_setfield(L, -2, "__index");
+}
+
 END_NS()
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Lua/Shared/LuaHelpers.h>
+#include <Lua/Shared/Proxies/LuaUserdata.h>
+
+BEGIN_NS(lua)
+
+// Vector or matrix value stored inline in a userdata.
+// Can be used in place of array tables (vec3 = { x, y, z }) to avoid allocating a table for each value.
+class MathValue : public Userdata<MathValue>, public Indexable, public NewIndexable,
+	public Lengthable, public Iterable, public Stringifiable, public EqualityComparable
+{
+public:
+	static char const* const MetatableName;
+	static constexpr unsigned MaxComponents = 16;
+
+	static MathValue* Make(lua_State* L, float const* values, unsigned arity);
+
+	inline static MathValue* Make(lua_State* L, glm::vec2 const& v)
+	{
+		return Make(L, &v.x, 2);
+	}
+
+	inline static MathValue* Make(lua_State* L, glm::vec3 const& v)
+	{
+		return Make(L, &v.x, 3);
+	}
+
+	inline static MathValue* Make(lua_State* L, glm::vec4 const& v)
+	{
+		return Make(L, &v.x, 4);
+	}
+
+	inline static MathValue* Make(lua_State* L, glm::mat3 const& m)
+	{
+		return Make(L, &m[0].x, 9);
+	}
+
+	inline static MathValue* Make(lua_State* L, glm::mat4 const& m)
+	{
+		return Make(L, &m[0].x, 16);
+	}
+
+	// Fetches a native value with the same number of components as T from the specified stack index
+	template <class T>
+	static T CheckedGet(lua_State* L, int index)
+	{
+		static_assert(sizeof(T) % sizeof(float) == 0 && sizeof(T) / sizeof(float) <= MaxComponents);
+		constexpr unsigned arity = sizeof(T) / sizeof(float);
+		auto self = CheckUserData(L, index);
+		if (self->arity_ != arity) {
+			luaL_error(L, "Param %d: expected %d-element value, got a %d-element value", index, arity, self->arity_);
+		}
+
+		T val;
+		std::copy(self->values_, self->values_ + arity, reinterpret_cast<float*>(&val));
+		return val;
+	}
+
+	template <class T>
+	static void CheckedAssign(lua_State* L, int index, T const& val)
+	{
+		static_assert(sizeof(T) % sizeof(float) == 0 && sizeof(T) / sizeof(float) <= MaxComponents);
+		constexpr unsigned arity = sizeof(T) / sizeof(float);
+		auto self = CheckUserData(L, index);
+		if (self->arity_ != arity) {
+			luaL_error(L, "Param %d: expected %d-element value, got a %d-element value", index, arity, self->arity_);
+		}
+
+		auto values = reinterpret_cast<float const*>(&val);
+		std::copy(values, values + arity, self->values_);
+	}
+
+	static void PopulateMetatable(lua_State* L);
+
+	inline unsigned Arity() const
+	{
+		return arity_;
+	}
+
+	inline float const* Values() const
+	{
+		return values_;
+	}
+
+	int Index(lua_State* L);
+	int NewIndex(lua_State* L);
+	int Length(lua_State* L);
+	int Next(lua_State* L);
+	int ToString(lua_State* L);
+	bool IsEqual(lua_State* L, MathValue* other);
+
+private:
+	friend Userdata<MathValue>;
+
+	uint32_t arity_;
+	// Only the first arity_ components are allocated
+	float values_[MaxComponents];
+
+	MathValue(unsigned arity)
+		: arity_(arity)
+	{}
+
+	std::optional<unsigned> GetComponentIndex(lua_State* L, int index);
+
+	template <class Op>
+	static int BinaryOp(lua_State* L);
+	static int Add(lua_State* L);
+	static int Sub(lua_State* L);
+	static int Mul(lua_State* L);
+	static int Div(lua_State* L);
+	static int Unm(lua_State* L);
+};
+
+END_NS()
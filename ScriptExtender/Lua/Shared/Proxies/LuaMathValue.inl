@@ -0,0 +1,261 @@
+#include <Lua/Shared/Proxies/LuaMathValue.h>
+
+BEGIN_NS(lua)
+
+char const* const MathValue::MetatableName = "MathValue";
+
+MathValue* MathValue::Make(lua_State* L, float const* values, unsigned arity)
+{
+	assert(arity > 0 && arity <= MaxComponents);
+	auto size = sizeof(MathValue) - (MaxComponents - arity) * sizeof(float);
+	auto self = reinterpret_cast<MathValue*>(lua_newuserdata(L, size));
+	new (self) MathValue(arity);
+	std::copy(values, values + arity, self->values_);
+	luaL_setmetatable(L, MetatableName);
+	return self;
+}
+
+std::optional<unsigned> MathValue::GetComponentIndex(lua_State* L, int index)
+{
+	switch (lua_type(L, index)) {
+	case LUA_TNUMBER:
+	{
+		auto idx = lua_tointeger(L, index);
+		if (idx >= 1 && idx <= (lua_Integer)arity_) {
+			return (unsigned)(idx - 1);
+		}
+		break;
+	}
+
+	case LUA_TSTRING:
+	{
+		// Named components are only available on vectors
+		std::size_t len;
+		auto name = lua_tolstring(L, index, &len);
+		if (len == 1 && arity_ <= 4) {
+			unsigned idx;
+			switch (name[0]) {
+			case 'x': idx = 0; break;
+			case 'y': idx = 1; break;
+			case 'z': idx = 2; break;
+			case 'w': idx = 3; break;
+			default: return {};
+			}
+
+			if (idx < arity_) {
+				return idx;
+			}
+		}
+		break;
+	}
+	}
+
+	return {};
+}
+
+int MathValue::Index(lua_State* L)
+{
+	StackCheck _(L, 1);
+	auto idx = GetComponentIndex(L, 2);
+	if (idx) {
+		push(L, values_[*idx]);
+	} else {
+		push(L, nullptr);
+	}
+
+	return 1;
+}
+
+int MathValue::NewIndex(lua_State* L)
+{
+	StackCheck _(L, 0);
+	auto idx = GetComponentIndex(L, 2);
+	if (!idx) {
+		luaL_error(L, "Cannot set component '%s' of a %d-element value", luaL_tolstring(L, 2, nullptr), arity_);
+		return 0;
+	}
+
+	values_[*idx] = (float)luaL_checknumber(L, 3);
+	return 0;
+}
+
+int MathValue::Length(lua_State* L)
+{
+	StackCheck _(L, 1);
+	push(L, arity_);
+	return 1;
+}
+
+int MathValue::Next(lua_State* L)
+{
+	unsigned next = 0;
+	if (lua_type(L, 2) != LUA_TNIL) {
+		next = (unsigned)luaL_checkinteger(L, 2);
+	}
+
+	if (next < arity_) {
+		StackCheck _(L, 2);
+		push(L, next + 1);
+		push(L, values_[next]);
+		return 2;
+	}
+
+	return 0;
+}
+
+int MathValue::ToString(lua_State* L)
+{
+	StackCheck _(L, 1);
+	char const* typeName;
+	switch (arity_) {
+	case 2: typeName = "vec2"; break;
+	case 3: typeName = "vec3"; break;
+	case 4: typeName = "vec4"; break;
+	case 9: typeName = "mat3"; break;
+	case 16: typeName = "mat4"; break;
+	default: typeName = "MathValue"; break;
+	}
+
+	char buf[32];
+	STDString str = typeName;
+	str += "(";
+	for (unsigned i = 0; i < arity_; i++) {
+		_snprintf_s(buf, std::size(buf) - 1, i > 0 ? ", %g" : "%g", values_[i]);
+		str += buf;
+	}
+	str += ")";
+
+	push(L, str);
+	return 1;
+}
+
+bool MathValue::IsEqual(lua_State* L, MathValue* other)
+{
+	return arity_ == other->arity_
+		&& std::equal(values_, values_ + arity_, other->values_);
+}
+
+template <class T>
+void PushMathResult(lua_State* L, T const& v)
+{
+	if constexpr (std::is_arithmetic_v<T>) {
+		push(L, v);
+	} else {
+		MathValue::Make(L, v);
+	}
+}
+
+template <class Fun>
+bool VisitMathParam(MathParam const& a, Fun const& fun)
+{
+	switch (a.Arity) {
+	case 1: return fun(a.f);
+	case 2: return fun(a.vec2);
+	case 3: return fun(a.vec3);
+	case 4: return fun(a.vec4);
+	case 9: return fun(a.mat3);
+	case 16: return fun(a.mat4);
+	default: return false;
+	}
+}
+
+struct MathAddOp
+{
+	template <class T1, class T2>
+	static auto Apply(T1 const& a, T2 const& b) -> decltype(a + b) { return a + b; }
+};
+
+struct MathSubOp
+{
+	template <class T1, class T2>
+	static auto Apply(T1 const& a, T2 const& b) -> decltype(a - b) { return a - b; }
+};
+
+struct MathMulOp
+{
+	template <class T1, class T2>
+	static auto Apply(T1 const& a, T2 const& b) -> decltype(a * b) { return a * b; }
+};
+
+struct MathDivOp
+{
+	template <class T1, class T2>
+	static auto Apply(T1 const& a, T2 const& b) -> decltype(a / b) { return a / b; }
+};
+
+template <class Op>
+int MathValue::BinaryOp(lua_State* L)
+{
+	StackCheck _(L, 1);
+	auto a = get<MathParam>(L, 1);
+	auto b = get<MathParam>(L, 2);
+
+	bool handled = VisitMathParam(a, [L, &b](auto const& x) {
+		return VisitMathParam(b, [L, &x](auto const& y) {
+			if constexpr (requires { Op::Apply(x, y); }) {
+				PushMathResult(L, Op::Apply(x, y));
+				return true;
+			} else {
+				return false;
+			}
+		});
+	});
+
+	if (!handled) {
+		luaL_error(L, "Unsupported argument arities: %d, %d", a.Arity, b.Arity);
+	}
+
+	return 1;
+}
+
+int MathValue::Add(lua_State* L)
+{
+	return BinaryOp<MathAddOp>(L);
+}
+
+int MathValue::Sub(lua_State* L)
+{
+	return BinaryOp<MathSubOp>(L);
+}
+
+int MathValue::Mul(lua_State* L)
+{
+	return BinaryOp<MathMulOp>(L);
+}
+
+int MathValue::Div(lua_State* L)
+{
+	return BinaryOp<MathDivOp>(L);
+}
+
+int MathValue::Unm(lua_State* L)
+{
+	StackCheck _(L, 1);
+	auto a = get<MathParam>(L, 1);
+	VisitMathParam(a, [L](auto const& x) {
+		PushMathResult(L, -x);
+		return true;
+	});
+
+	return 1;
+}
+
+void MathValue::PopulateMetatable(lua_State* L)
+{
+	lua_pushcfunction(L, &Add);
+	lua_setfield(L, -2, "__add");
+
+	lua_pushcfunction(L, &Sub);
+	lua_setfield(L, -2, "__sub");
+
+	lua_pushcfunction(L, &Mul);
+	lua_setfield(L, -2, "__mul");
+
+	lua_pushcfunction(L, &Div);
+	lua_setfield(L, -2, "__div");
+
+	lua_pushcfunction(L, &Unm);
+	lua_setfield(L, -2, "__unm");
+}
+
+END_NS()
@@ -9,7 +9,7 @@ BEGIN_NS(lua)
 void CopyRawProperties(GenericPropertyMap const& base, GenericPropertyMap& child)
 {
 	for (auto const& prop : base.Properties) {
-		child.AddRawProperty(prop.first.GetString(), prop.second.Get, prop.second.Set, prop.second.Offset, prop.second.Flag);
+		child.AddRawProperty(prop.Name.GetString(), prop.Get, prop.Set, prop.Offset, prop.Flag);
 	}
 
 	for (auto const& parent : base.Parents) {
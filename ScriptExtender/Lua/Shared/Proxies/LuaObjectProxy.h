@@ -78,31 +78,25 @@ struct ObjectProxyHelpers
 	static int Next(lua_State* L, T* object, LifetimeHandle const& lifetime, FixedString const& key)
 	{
 		auto const& map = StaticLuaPropertyMap<T>::PropertyMap;
-		if (!key) {
-			if (!map.Properties.empty()) {
-				StackCheck _(L, 2);
-				auto it = map.Properties.begin();
-				push(L, it->first);
-				if (map.GetProperty(L, lifetime, object, it->second) != PropertyOperationResult::Success) {
-					push(L, nullptr);
-				}
-
-				return 2;
+		uint32_t index = 0;
+		if (key) {
+			auto prop = map.FindProperty(key);
+			if (prop == nullptr) {
+				return 0;
 			}
-		} else {
-			auto it = map.Properties.find(key);
-			if (it != map.Properties.end()) {
-				++it;
-				if (it != map.Properties.end()) {
-					StackCheck _(L, 2);
-					push(L, it->first);
-					if (map.GetProperty(L, lifetime, object, it->second) != PropertyOperationResult::Success) {
-						push(L, nullptr);
-					}
-
-					return 2;
-				}
+
+			index = prop->Index + 1;
+		}
+
+		if (index < map.Properties.size()) {
+			StackCheck _(L, 2);
+			auto const& prop = map.Properties[index];
+			push(L, prop.Name);
+			if (map.GetProperty(L, lifetime, object, prop) != PropertyOperationResult::Success) {
+				push(L, nullptr);
 			}
+
+			return 2;
 		}
 
 		return 0;
@@ -13,19 +13,45 @@ void GenericPropertyMap::Init(int registryIndex)
 void GenericPropertyMap::Finish()
 {
 	assert(!Initialized && IsInitializing);
+
+	// Inherited properties were already copied into this map by InheritProperties(),
+	// so lookups never have to walk the parent chain
+	Properties.shrink_to_fit();
+
 	IsInitializing = false;
 	Initialized = true;
 }
 
 bool GenericPropertyMap::HasProperty(FixedString const& prop) const
 {
-	return Properties.find(prop) != Properties.end();
+	return FindProperty(prop) != nullptr;
+}
+
+GenericPropertyMap::RawPropertyAccessors const* GenericPropertyMap::FindProperty(FixedString const& prop) const
+{
+	auto key = reinterpret_cast<uint64_t>(prop.GetString());
+	auto& slot = lookupCache_[GetLookupCacheSlot(key)];
+	auto cached = slot.load(std::memory_order_relaxed);
+	if (key != 0 && (cached & LookupCacheKeyMask) == key) {
+		return &Properties[(cached >> 48) - 1];
+	}
+
+	auto it = PropertyIndices.find(prop);
+	if (it == PropertyIndices.end()) {
+		return nullptr;
+	}
+
+	if (Initialized && it->second < 0xffff) {
+		slot.store(key | ((uint64_t)(it->second + 1) << 48), std::memory_order_relaxed);
+	}
+
+	return &Properties[it->second];
 }
 
 PropertyOperationResult GenericPropertyMap::GetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop) const
 {
-	auto it = Properties.find(prop);
-	if (it == Properties.end()) {
+	auto property = FindProperty(prop);
+	if (property == nullptr) {
 		if (FallbackGetter) {
 			return FallbackGetter(L, lifetime, object, prop);
 		} else {
@@ -33,13 +59,13 @@ PropertyOperationResult GenericPropertyMap::GetRawProperty(lua_State* L, Lifetim
 		}
 	}
 
-	return it->second.Get(L, lifetime, object, it->second.Offset, it->second.Flag);
+	return property->Get(L, lifetime, object, property->Offset, property->Flag);
 }
 
 PropertyOperationResult GenericPropertyMap::SetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop, int index) const
 {
-	auto it = Properties.find(prop);
-	if (it == Properties.end()) {
+	auto property = FindProperty(prop);
+	if (property == nullptr) {
 		if (FallbackSetter) {
 			return FallbackSetter(L, lifetime, object, prop, index);
 		} else {
@@ -47,7 +73,7 @@ PropertyOperationResult GenericPropertyMap::SetRawProperty(lua_State* L, Lifetim
 		}
 	}
 
-	return it->second.Set(L, lifetime, object, index, it->second.Offset, it->second.Flag);
+	return property->Set(L, lifetime, object, index, property->Offset, property->Flag);
 }
 
 void GenericPropertyMap::AddRawProperty(char const* prop, typename RawPropertyAccessors::Getter* getter,
@@ -55,8 +81,10 @@ void GenericPropertyMap::AddRawProperty(char const* prop, typename RawPropertyAc
 {
 	assert(!Initialized && IsInitializing);
 	auto key = FixedString(prop);
-	assert(Properties.find(key) == Properties.end());
-	Properties.insert(std::make_pair(key, RawPropertyAccessors{ key, getter, setter, offset, flag }));
+	assert(PropertyIndices.find(key) == PropertyIndices.end());
+	auto index = (uint32_t)Properties.size();
+	Properties.push_back(RawPropertyAccessors{ key, getter, setter, offset, flag, index });
+	PropertyIndices.insert(std::make_pair(key, index));
 }
 
 bool GenericPropertyMap::IsA(int typeRegistryIndex) const
@@ -3,6 +3,7 @@
 #include <Lua/Shared/LuaHelpers.h>
 #include <Lua/Shared/LuaLifetime.h>
 #include <Lua/Shared/Proxies/LuaUserdata.h>
+#include <atomic>
 
 BEGIN_NS(lua)
 
@@ -22,11 +23,14 @@ public:
 		Setter* Set;
 		std::size_t Offset;
 		uint64_t Flag;
+		// Dense index of the property in registration order
+		uint32_t Index;
 	};
 
 	void Init(int registryIndex);
 	void Finish();
 	bool HasProperty(FixedString const& prop) const;
+	RawPropertyAccessors const* FindProperty(FixedString const& prop) const;
 	PropertyOperationResult GetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop) const;
 	PropertyOperationResult SetRawProperty(lua_State* L, LifetimeHandle const& lifetime, void* object, FixedString const& prop, int index) const;
 	void AddRawProperty(char const* prop, typename RawPropertyAccessors::Getter* getter,
@@ -34,7 +38,9 @@ public:
 	bool IsA(int typeRegistryIndex) const;
 
 	FixedString Name;
-	std::unordered_map<FixedString, RawPropertyAccessors> Properties;
+	// Properties in registration order; RawPropertyAccessors::Index is the position in this list
+	std::vector<RawPropertyAccessors> Properties;
+	std::unordered_map<FixedString, uint32_t> PropertyIndices;
 	std::vector<FixedString> Parents;
 	std::vector<int> ParentRegistryIndices;
 	TFallbackGetter* FallbackGetter{ nullptr };
@@ -42,6 +48,19 @@ public:
 	bool IsInitializing{ false };
 	bool Initialized{ false };
 	int RegistryIndex{ -1 };
+
+private:
+	// Direct-mapped inline cache of recent property lookups.
+	// Each slot packs the FixedString pointer (lower 48 bits) and property index + 1 (upper 16 bits)
+	// into a single word, so slots can be updated from the client and server threads without locking.
+	static constexpr unsigned LookupCacheBits = 6;
+	static constexpr uint64_t LookupCacheKeyMask = (1ull << 48) - 1;
+	mutable std::array<std::atomic<uint64_t>, (1 << LookupCacheBits)> lookupCache_;
+
+	static inline std::size_t GetLookupCacheSlot(uint64_t key)
+	{
+		return (std::size_t)((key * 0x9E3779B97F4A7C15ull) >> (64 - LookupCacheBits));
+	}
 };
 
 inline PropertyOperationResult GenericSetNonWriteableProperty(lua_State* L, LifetimeHandle const& lifetime, void* obj, int index, std::size_t offset, uint64_t)
@@ -109,7 +109,7 @@ end
 -- Used by the Lua debug adapter to store intermediate evaluation results.
 -- Should not be used manually!
 Ext.DebugEvaluate = function (retval)
-	if type(retval) ~= "table" then
+	if type(retval) ~= "table" and type(retval) ~= "userdata" then
 		return retval
 	else
 		local idx = #Ext._EVAL_ROOTS_ + 1
@@ -8501,16 +8501,58 @@ local Ext_Debug = {}
 
 function Ext_Debug.DebugDumpLifetimes() end
 
+--- Prints the handlers with the highest total execution time to the console.
+--- @param limit integer|nil Number of handlers to print (default 20)
+function Ext_Debug.DumpEventStats(limit) end
+
 function Ext_Debug.DumpNetworking() end
 
 function Ext_Debug.DumpStack() end
 
+--- Performs a full garbage collection cycle and records it in the GC scheduler counters.
+function Ext_Debug.FullGC() end
+
 --- @param builtinOnly boolean|nil 
 function Ext_Debug.GenerateIdeHelpers(builtinOnly) end
 
+--- Returns event and handler latency statistics (in microseconds) collected while event profiling was enabled.
+--- Handlers are identified by the location where the handler function was defined.
+--- @return table
+function Ext_Debug.GetEventStats() end
+
+--- Returns the counters of the incremental garbage collection scheduler of the current Lua state.
+--- @return table
+function Ext_Debug.GetGCStats() end
+
+--- Returns the stacks collected by the sampling profiler in the folded stack format.
+--- @return string
+function Ext_Debug.GetProfilerStacks() end
+
 --- @return boolean
 function Ext_Debug.IsDeveloperMode() end
 
+--- Clears the event latency statistics collected so far.
+function Ext_Debug.ResetEventStats() end
+
+--- Enables or disables latency tracking for engine events and their handlers.
+--- @param enabled boolean
+function Ext_Debug.SetEventProfiling(enabled) end
+
+--- Sets the maximum time (in microseconds) spent on incremental garbage collection per tick.
+--- @param budget integer
+function Ext_Debug.SetGCBudget(budget) end
+
+--- Starts the sampling profiler on the current Lua state.
+--- @param interval integer|nil Sampling interval in microseconds (default 1000)
+--- @param maxStacks integer|nil Maximum number of distinct call stacks to keep (default 20000)
+--- @return boolean
+function Ext_Debug.StartProfiler(interval, maxStacks) end
+
+--- Stops the sampling profiler and optionally writes the collected stacks to a file in the folded stack format.
+--- @param path string|nil Output path, relative to the script extender storage directory
+--- @return boolean
+function Ext_Debug.StopProfiler(path) end
+
 
 
 --- @class Ext_IO
@@ -9122,6 +9164,10 @@ function Ext_ServerNet.PostMessageToUser(userId, channel, payload) end
 local Ext_ServerOsiris = {}
 
 
+--- Returns the usage counters of the argument pools used when calling Osiris from Lua.
+--- @return table
+function Ext_ServerOsiris.GetArgumentPoolStats() end
+
 --- @return boolean
 function Ext_ServerOsiris.IsCallable() end
 
@@ -10685,6 +10731,14 @@ function Ext_Types.GetObjectType(object) end
 --- @return TypeInformation
 function Ext_Types.GetTypeInfo(typeName) end
 
+--- Copies the properties of an object into a plain Lua table in a single call.
+--- Nested objects, arrays and maps are copied up to the specified depth; deeper objects are returned as-is.
+--- @param object any Object to copy
+--- @param fields FixedString[]|nil Optional list of top-level properties to copy; copies all properties if `nil`
+--- @param depth integer|nil Number of nested object levels to copy; default: 0
+--- @return table
+function Ext_Types.Snapshot(object, fields, depth) end
+
 
 
 --- @class ComponentHandleProxy:userdata
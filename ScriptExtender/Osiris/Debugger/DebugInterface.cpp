@@ -55,30 +55,93 @@ namespace dse
 		return clientSocket_ != 0;
 	}
 
-	void SocketInterface::SendProtobufMessage(uint8_t* buf, uint32_t length)
+	bool SocketInterface::CanQueueTrace(uint32_t length)
+	{
+		std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+		return sendBuf_.size() - sendPos_ + length + 4 <= MaxTraceQueuedBytes;
+	}
+
+	void SocketInterface::SendProtobufMessage(uint8_t* buf, uint32_t length, MessagePriority priority)
 	{
 		if (clientSocket_ == 0) {
 			DEBUG("ProtobufSocketInterface::Send(): Not connected to debugger frontend");
 			return;
 		}
 
+		std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+		// Wait until the frontend catches up instead of growing the queue indefinitely
+		if (sendBuf_.size() - sendPos_ + length + 4 > MaxQueuedBytes) {
+			FlushAndWait();
+		}
+
+		// Messages are queued in their wire format, so a flush is a single socket write
 		uint32_t packetSize = length + 4;
-		Send((uint8_t*)&packetSize, 4);
-		Send(buf, length);
+		sendBuf_.insert(sendBuf_.end(), (uint8_t*)&packetSize, (uint8_t*)&packetSize + 4);
+		sendBuf_.insert(sendBuf_.end(), buf, buf + length);
+
+		if (priority == MessagePriority::Immediate) {
+			FlushAndWait();
+		} else if (sendBuf_.size() - sendPos_ >= FlushThreshold) {
+			WriteQueued();
+		}
+	}
+
+	void SocketInterface::Flush()
+	{
+		std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+		WriteQueued();
 	}
 
-	void SocketInterface::Send(uint8_t * buf, uint32_t length)
+	bool SocketInterface::WriteQueued()
 	{
-		while (length > 0) {
-			int sent = send(clientSocket_, (char *)buf, (int)length, 0);
+		if (clientSocket_ == 0 || sendFailed_) {
+			sendBuf_.clear();
+			sendPos_ = 0;
+			return false;
+		}
+
+		while (sendPos_ < sendBuf_.size()) {
+			int sent = send(clientSocket_, (char *)sendBuf_.data() + sendPos_, (int)(sendBuf_.size() - sendPos_), 0);
+			if (sent == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) {
+				// Socket buffer is full, keep the rest queued until the next flush
+				break;
+			}
+
 			if (sent <= 0) {
 				ERR("Socket send failed: %d, error %d", sent, WSAGetLastError());
-				Disconnect();
-				return;
+				// The sender may be holding locks that the disconnect handler needs;
+				// the message loop will notice the shutdown and disconnect from its own thread
+				sendFailed_ = true;
+				shutdown(clientSocket_, SD_BOTH);
+				sendBuf_.clear();
+				sendPos_ = 0;
+				return false;
 			}
 
-			buf += sent;
-			length -= sent;
+			sendPos_ += sent;
+		}
+
+		if (sendPos_ == sendBuf_.size()) {
+			sendBuf_.clear();
+			sendPos_ = 0;
+		} else if (sendPos_ >= FlushThreshold) {
+			sendBuf_.erase(sendBuf_.begin(), sendBuf_.begin() + sendPos_);
+			sendPos_ = 0;
+		}
+
+		return true;
+	}
+
+	void SocketInterface::FlushAndWait()
+	{
+		while (WriteQueued() && sendPos_ < sendBuf_.size()) {
+			fd_set writeSet;
+			FD_ZERO(&writeSet);
+			FD_SET(clientSocket_, &writeSet);
+			if (select(0, nullptr, &writeSet, nullptr, nullptr) == SOCKET_ERROR) {
+				ERR("Socket select failed: error %d", WSAGetLastError());
+				break;
+			}
 		}
 	}
 
@@ -86,8 +149,14 @@ namespace dse
 	{
 		if (!IsConnected()) return;
 
-		closesocket(clientSocket_);
-		clientSocket_ = 0;
+		{
+			// Make sure that no flush is writing to the socket while it's being closed
+			std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+			closesocket(clientSocket_);
+			clientSocket_ = 0;
+			sendBuf_.clear();
+			sendPos_ = 0;
+		}
 
 		if (disconnectHandler_) {
 			disconnectHandler_();
@@ -105,12 +174,30 @@ namespace dse
 	{
 		receivePos_ = 0;
 		for (;;) {
+			// The client socket is non-blocking, wait until there is something to read
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(sock, &readSet);
+			if (select(0, &readSet, nullptr, nullptr, nullptr) == SOCKET_ERROR) {
+				ERR("Socket select failed: error %d", WSAGetLastError());
+				return;
+			}
+
 			int len = recv(sock, (char *)&receiveBuf_[receivePos_], sizeof(receiveBuf_) - receivePos_, 0);
+			if (len == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) {
+				continue;
+			}
+
 			if (len < 0) {
 				ERR("Socket recv failed: %d, error %d", len, WSAGetLastError());
 				return;
 			}
 
+			if (len == 0) {
+				DEBUG("Debug connection closed.");
+				return;
+			}
+
 			receivePos_ += len;
 			while (receivePos_ >= 4) {
 				uint32_t messageLength = *reinterpret_cast<uint32_t *>(&receiveBuf_[0]);
@@ -141,7 +228,12 @@ namespace dse
 		for (;;) {
 			sockaddr_in addr;
 			int addrlen = sizeof(addr);
-			clientSocket_ = accept(socket_, (sockaddr *)&addr, &addrlen);
+			auto clientSocket = accept(socket_, (sockaddr *)&addr, &addrlen);
+			// Writes from the server thread must never block on a slow frontend
+			u_long nonBlocking = 1;
+			ioctlsocket(clientSocket, FIONBIO, &nonBlocking);
+			sendFailed_ = false;
+			clientSocket_ = clientSocket;
 			DEBUG("Accepted debug connection.");
 			if (connectHandler_) {
 				connectHandler_();
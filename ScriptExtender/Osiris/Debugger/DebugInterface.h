@@ -12,9 +12,26 @@
 
 namespace dse
 {
+	enum class MessagePriority
+	{
+		// Diagnostic messages that are dropped if the frontend can't keep up with them
+		Trace,
+		// Queued and sent without blocking the sender
+		Normal,
+		// Sent right away, waiting for the frontend if necessary
+		Immediate
+	};
+
 	class SocketInterface
 	{
 	public:
+		// Queued messages are written to the socket (without blocking) when the queue reaches this size
+		static constexpr uint32_t FlushThreshold = 0x10000;
+		// Trace messages are dropped instead of being queued above this size
+		static constexpr uint32_t MaxTraceQueuedBytes = 0x100000;
+		// Normal messages wait for the frontend instead of being queued above this size
+		static constexpr uint32_t MaxQueuedBytes = 0x400000;
+
 		SocketInterface(uint16_t port);
 		~SocketInterface();
 
@@ -23,16 +40,20 @@ namespace dse
 			std::function<void()> disconnectHandler
 		);
 		bool IsConnected() const;
+		bool CanQueueTrace(uint32_t length);
+		// Writes as much of the send queue as the socket accepts without blocking
+		void Flush();
 		void Run();
 		void Disconnect();
 		void Shutdown();
 
 	protected:
-		void SendProtobufMessage(uint8_t* buf, uint32_t length);
+		void SendProtobufMessage(uint8_t* buf, uint32_t length, MessagePriority priority);
 		virtual bool ProcessMessage(uint8_t* buf, uint32_t length) = 0;
 
 	private:
-		void Send(uint8_t* buf, uint32_t length);
+		bool WriteQueued();
+		void FlushAndWait();
 		void MessageLoop(SOCKET sock);
 
 		uint16_t port_;
@@ -40,6 +61,12 @@ namespace dse
 		SOCKET clientSocket_{ 0 };
 		uint8_t receiveBuf_[0x10000];
 		uint32_t receivePos_;
+		// Outbound messages that weren't written to the socket yet
+		std::vector<uint8_t> sendBuf_;
+		// Number of bytes at the start of the send buffer that were already written
+		std::size_t sendPos_{ 0 };
+		std::recursive_mutex sendMutex_;
+		bool sendFailed_{ false };
 		std::function<void()> connectHandler_;
 		std::function<void()> disconnectHandler_;
 	};
@@ -58,7 +85,7 @@ namespace dse
 			messageHandler_ = messageHandler;
 		}
 
-		void Send(TSendMsg const & msg)
+		void Send(TSendMsg const & msg, MessagePriority priority = MessagePriority::Immediate)
 		{
 			uint32_t size = (uint32_t)msg.ByteSizeLong();
 
@@ -67,7 +94,7 @@ namespace dse
 				Fail("Unable to serialize message");
 			}
 
-			SendProtobufMessage(buf, size);
+			SendProtobufMessage(buf, size, priority);
 			GameFree(buf);
 		}
 
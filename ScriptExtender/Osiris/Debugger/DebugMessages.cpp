@@ -258,7 +258,7 @@ namespace dse::osidbg
 		goalInfo->set_name(goal->Name);
 		AddActionInfo(goal->InitCalls, [goalInfo]() -> MsgActionInfo * { return goalInfo->add_initactions(); });
 		AddActionInfo(goal->ExitCalls, [goalInfo]() -> MsgActionInfo * { return goalInfo->add_exitactions(); });
-		Send(msg);
+		Send(msg, MessagePriority::Normal);
 		DEBUG(" <-- BkSyncStoryData(Goal #%d)", goal->Id);
 	}
 
@@ -277,7 +277,7 @@ namespace dse::osidbg
 			}
 		}
 
-		Send(msg);
+		Send(msg, MessagePriority::Normal);
 		DEBUG(" <-- BkSyncStoryData(%d databases)", count);
 	}
 
@@ -304,7 +304,7 @@ namespace dse::osidbg
 			}
 		}
 
-		Send(msg);
+		Send(msg, MessagePriority::Normal);
 		DEBUG(" <-- BkSyncStoryData(%d nodes)", count);
 	}
 
@@ -321,7 +321,7 @@ namespace dse::osidbg
 		BackendToDebugger msg;
 		auto debugMsg = msg.mutable_debugoutput();
 		debugMsg->set_message(message);
-		Send(msg);
+		Send(msg, MessagePriority::Trace);
 
 		if (IsConnected()) {
 			DEBUG(" <-- BkDebugOutput(): \"%s\"", message);
@@ -400,7 +400,8 @@ namespace dse::osidbg
 
 	void DebugMessageHandler::HandleGetDatabaseContents(uint32_t seq, DbgGetDatabaseContents const & req)
 	{
-		DEBUG(" --> DbgGetDatabaseContents(%d)", req.database_id());
+		DEBUG(" --> DbgGetDatabaseContents(%d, offset %d, limit %d, %d filters)",
+			req.database_id(), req.offset(), req.limit(), req.filter_size());
 
 		ResultCode rc;
 		if (!debugger_) {
@@ -409,7 +410,24 @@ namespace dse::osidbg
 		}
 		else
 		{
-			rc = debugger_->GetDatabaseContents(req.database_id());
+			rc = debugger_->GetDatabaseContents(req.database_id(), req.offset(), req.limit(), req.filter());
+		}
+
+		SendResult(seq, rc);
+	}
+
+	void DebugMessageHandler::HandleGetDatabaseRowCount(uint32_t seq, DbgGetDatabaseRowCount const & req)
+	{
+		DEBUG(" --> DbgGetDatabaseRowCount(%d, %d filters)", req.database_id(), req.filter_size());
+
+		ResultCode rc;
+		if (!debugger_) {
+			WARN("GetDatabaseRowCount: Not attached to story debugger!");
+			rc = ResultCode::NoDebuggee;
+		}
+		else
+		{
+			rc = debugger_->GetDatabaseRowCount(seq, req.database_id(), req.filter());
 		}
 
 		SendResult(seq, rc);
@@ -492,6 +510,10 @@ namespace dse::osidbg
 			HandleGetDatabaseContents(seq, msg->getdatabasecontents());
 			break;
 
+		case DebuggerToBackend::kGetDatabaseRowCount:
+			HandleGetDatabaseRowCount(seq, msg->getdatabaserowcount());
+			break;
+
 		case DebuggerToBackend::kSyncStory:
 			HandleSyncStory(seq, msg->syncstory());
 			break;
@@ -527,11 +549,30 @@ namespace dse::osidbg
 		}
 	}
 
-	void DebugMessageHandler::Send(BackendToDebugger & msg)
+	void DebugMessageHandler::Send(BackendToDebugger & msg, MessagePriority priority)
 	{
-		if (intf_.IsConnected()) {
-			msg.set_seq_no(outboundSeq_++);
-			intf_.Send(msg);
+		if (!intf_.IsConnected()) return;
+
+		// Sequence numbers must be assigned in the order messages are written to the send buffer,
+		// and dropped messages must not consume a sequence number
+		std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+		if (priority == MessagePriority::Trace && !intf_.CanQueueTrace((uint32_t)msg.ByteSizeLong())) {
+			droppedMessages_++;
+			return;
+		}
+
+		msg.set_seq_no(outboundSeq_++);
+		intf_.Send(msg, priority);
+	}
+
+	void DebugMessageHandler::Flush()
+	{
+		std::lock_guard<std::recursive_mutex> lk(sendMutex_);
+		intf_.Flush();
+
+		if (droppedMessages_ > 0) {
+			WARN("Osiris debugger frontend is not keeping up; dropped %d debug output messages", droppedMessages_);
+			droppedMessages_ = 0;
 		}
 	}
 
@@ -570,30 +611,46 @@ namespace dse::osidbg
 		BackendToDebugger msg;
 		auto beginMsg = msg.mutable_begindatabasecontents();
 		beginMsg->set_database_id(databaseId);
-		Send(msg);
+		Send(msg, MessagePriority::Normal);
 		DEBUG(" <-- BkBeginDatabaseContents()");
 	}
 
-	void DebugMessageHandler::SendDatabaseRow(uint32_t databaseId, TupleVec * row)
+	void DebugMessageHandler::SendDatabaseRows(uint32_t databaseId, TupleVec ** rows, uint32_t count)
 	{
 		BackendToDebugger msg;
 		auto rowMsg = msg.mutable_databaserow();
 		rowMsg->set_database_id(databaseId);
 
-		auto msgRow = rowMsg->add_row();
-		MakeMsgTuple(*msgRow, *row);
+		for (uint32_t i = 0; i < count; i++) {
+			auto msgRow = rowMsg->add_row();
+			MakeMsgTuple(*msgRow, *rows[i]);
+		}
 
-		Send(msg);
-		DEBUG(" <-- BkDatabaseRow()");
+		Send(msg, MessagePriority::Normal);
+		DEBUG(" <-- BkDatabaseRow(%d rows)", count);
 	}
 
-	void DebugMessageHandler::SendEndDatabaseContents(uint32_t databaseId)
+	void DebugMessageHandler::SendEndDatabaseContents(uint32_t databaseId, uint32_t rowCount, bool hasMore)
 	{
 		BackendToDebugger msg;
 		auto endMsg = msg.mutable_enddatabasecontents();
 		endMsg->set_database_id(databaseId);
+		endMsg->set_row_count(rowCount);
+		endMsg->set_has_more(hasMore);
+		Send(msg, MessagePriority::Normal);
+		DEBUG(" <-- BkEndDatabaseContents(%d rows)", rowCount);
+	}
+
+	void DebugMessageHandler::SendDatabaseRowCount(uint32_t seq, uint32_t databaseId, uint32_t totalRows, uint32_t matchingRows)
+	{
+		BackendToDebugger msg;
+		msg.set_reply_seq_no(seq);
+		auto countMsg = msg.mutable_databaserowcount();
+		countMsg->set_database_id(databaseId);
+		countMsg->set_total_rows(totalRows);
+		countMsg->set_matching_rows(matchingRows);
 		Send(msg);
-		DEBUG(" <-- BkEndDatabaseContents()");
+		DEBUG(" <-- BkDatabaseRowCount(%d, %d)", totalRows, matchingRows);
 	}
 
 	void DebugMessageHandler::SendEvaluateRow(uint32_t seq, VirtTupleLL & row)
@@ -604,7 +661,7 @@ namespace dse::osidbg
 		auto msgRow = rowMsg->add_row();
 		MakeMsgTuple(*msgRow, row.Data);
 
-		Send(msg);
+		Send(msg, MessagePriority::Normal);
 		DEBUG(" <-- BkEvaluateRow()");
 	}
 
@@ -83,7 +83,7 @@ namespace dse::osidbg
 	class DebugMessageHandler
 	{
 	public:
-		static const uint32_t ProtocolVersion = 8;
+		static const uint32_t ProtocolVersion = 9;
 
 		DebugMessageHandler(OsirisDebugInterface& intf);
 
@@ -93,6 +93,8 @@ namespace dse::osidbg
 		}
 
 		void SetDebugger(Debugger * debugger);
+		// Writes queued messages to the socket without blocking; called once per server tick
+		void Flush();
 		void SendBreakpointTriggered(Vector<CallStackFrame> const & callStack,
 			QueryResultInfo const * results = nullptr);
 		void SendGlobalBreakpointTriggered(GlobalBreakpointReason reason);
@@ -104,8 +106,9 @@ namespace dse::osidbg
 		void SendSyncStoryFinished();
 		void SendDebugOutput(char const * message);
 		void SendBeginDatabaseContents(uint32_t databaseId);
-		void SendDatabaseRow(uint32_t databaseId, TupleVec * row);
-		void SendEndDatabaseContents(uint32_t databaseId);
+		void SendDatabaseRows(uint32_t databaseId, TupleVec ** rows, uint32_t count);
+		void SendEndDatabaseContents(uint32_t databaseId, uint32_t rowCount, bool hasMore);
+		void SendDatabaseRowCount(uint32_t seq, uint32_t databaseId, uint32_t totalRows, uint32_t matchingRows);
 		void SendEvaluateRow(uint32_t seq, VirtTupleLL & row);
 		void SendEvaluateFinished(uint32_t seq, ResultCode rc, bool querySucceeded);
 
@@ -114,6 +117,8 @@ namespace dse::osidbg
 		Debugger * debugger_{ nullptr };
 		uint32_t inboundSeq_{ 1 };
 		uint32_t outboundSeq_{ 1 };
+		std::recursive_mutex sendMutex_;
+		uint32_t droppedMessages_{ 0 };
 
 		bool HandleMessage(DebuggerToBackend const * msg);
 		void HandleConnect();
@@ -124,10 +129,11 @@ namespace dse::osidbg
 		void HandleSetBreakpoints(uint32_t seq, DbgSetBreakpoints const & req);
 		void HandleContinue(uint32_t seq, DbgContinue const & req);
 		void HandleGetDatabaseContents(uint32_t seq, DbgGetDatabaseContents const & req);
+		void HandleGetDatabaseRowCount(uint32_t seq, DbgGetDatabaseRowCount const & req);
 		void HandleSyncStory(uint32_t seq, DbgSyncStory const & req);
 		void HandleEvaluate(uint32_t seq, DbgEvaluate const & req);
 
-		void Send(BackendToDebugger & msg);
+		void Send(BackendToDebugger & msg, MessagePriority priority = MessagePriority::Immediate);
 		void SendVersionInfo(uint32_t seq);
 		void SendResult(uint32_t seq, ResultCode code);
 	};
@@ -384,35 +384,144 @@ namespace dse::osidbg
 		}
 	}
 
-	ResultCode Debugger::GetDatabaseContents(uint32_t databaseId)
+	bool MatchesColumnFilter(TypedValue const & tv, MsgTypedValue const & filter)
+	{
+		auto const & val = tv.Value.Val;
+
+		switch (filter.value_case()) {
+		case MsgTypedValue::kIntval:
+			if ((ValueType)tv.TypeId == ValueType::Integer) return val.Int32 == filter.intval();
+			if ((ValueType)tv.TypeId == ValueType::Integer64) return val.Int64 == filter.intval();
+			return false;
+
+		case MsgTypedValue::kFloatval:
+			return (ValueType)tv.TypeId == ValueType::Real && val.Float == filter.floatval();
+
+		case MsgTypedValue::kStringval:
+			if (tv.TypeId < (uint32_t)ValueType::String || val.String == nullptr) return false;
+			if ((ValueType)tv.TypeId == ValueType::String) {
+				return strcmp(val.String, filter.stringval().c_str()) == 0;
+			} else {
+				// GUIDs are case insensitive
+				return _stricmp(val.String, filter.stringval().c_str()) == 0;
+			}
+
+		default:
+			return false;
+		}
+	}
+
+	bool MatchesColumnFilters(TupleVec const & row, ColumnFilterList const & filters)
+	{
+		for (auto const & filter : filters) {
+			if (filter.column() >= row.Size
+				|| !MatchesColumnFilter(row.Values[filter.column()], filter.value())) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	ResultCode Debugger::GetReadableDatabase(uint32_t databaseId, ColumnFilterList const & filters, Database *& db)
 	{
 		auto & dbs = (*globals_.Databases)->Db;
 		if (databaseId == 0 || databaseId > dbs.Size)
 		{
-			WARN("Debugger::GetDatabaseContents(): Invalid database ID %d", databaseId);
+			WARN("Debugger::GetReadableDatabase(): Invalid database ID %d", databaseId);
 			return ResultCode::InvalidDatabaseId;
 		}
 
 		if (!isPaused_) {
 			// Technically we can read rows anytime, but its not thread-safe and there 
 			// is a slight chance of crashing.
-			WARN("Debugger::GetDatabaseContents(): Cannot read rows while story is running!");
+			WARN("Debugger::GetReadableDatabase(): Cannot read rows while story is running!");
 			return ResultCode::NotInPause;
 		}
 
-		auto & db = dbs.Start[databaseId - 1];
+		db = dbs.Start[databaseId - 1];
+		for (auto const & filter : filters) {
+			if (filter.column() >= db->NumParams
+				|| filter.value().value_case() == MsgTypedValue::VALUE_NOT_SET) {
+				WARN("Debugger::GetReadableDatabase(): Invalid filter on column %d", filter.column());
+				return ResultCode::InvalidParameters;
+			}
+		}
+
+		return ResultCode::Success;
+	}
+
+	ResultCode Debugger::GetDatabaseContents(uint32_t databaseId, uint32_t offset, uint32_t limit, ColumnFilterList const & filters)
+	{
+		Database * db;
+		auto rc = GetReadableDatabase(databaseId, filters, db);
+		if (rc != ResultCode::Success) {
+			return rc;
+		}
+
 		auto const & facts = db->Facts;
 		auto head = facts.Head;
 		auto current = head->Next;
 
+		TupleVec * rows[DatabaseRowsPerMessage];
+		uint32_t numBuffered{ 0 }, numSent{ 0 }, numSkipped{ 0 };
+		bool hasMore{ false };
+
 		messageHandler_.SendBeginDatabaseContents(databaseId);
-		while (current != head) {
-			messageHandler_.SendDatabaseRow(databaseId, &current->Item);
-			current = current->Next;
+		for (; current != head; current = current->Next) {
+			if (!filters.empty() && !MatchesColumnFilters(current->Item, filters)) {
+				continue;
+			}
+
+			if (numSkipped < offset) {
+				numSkipped++;
+				continue;
+			}
+
+			if (limit != 0 && numSent + numBuffered >= limit) {
+				hasMore = true;
+				break;
+			}
+
+			rows[numBuffered++] = &current->Item;
+			if (numBuffered == DatabaseRowsPerMessage) {
+				messageHandler_.SendDatabaseRows(databaseId, rows, numBuffered);
+				numSent += numBuffered;
+				numBuffered = 0;
+			}
 		}
 
-		messageHandler_.SendEndDatabaseContents(databaseId);
+		if (numBuffered > 0) {
+			messageHandler_.SendDatabaseRows(databaseId, rows, numBuffered);
+			numSent += numBuffered;
+		}
+
+		messageHandler_.SendEndDatabaseContents(databaseId, numSent, hasMore);
+
+		return ResultCode::Success;
+	}
+
+	ResultCode Debugger::GetDatabaseRowCount(uint32_t seq, uint32_t databaseId, ColumnFilterList const & filters)
+	{
+		Database * db;
+		auto rc = GetReadableDatabase(databaseId, filters, db);
+		if (rc != ResultCode::Success) {
+			return rc;
+		}
+
+		auto const & facts = db->Facts;
+		uint32_t matchingRows = (uint32_t)facts.Size;
+		if (!filters.empty()) {
+			matchingRows = 0;
+			auto head = facts.Head;
+			for (auto current = head->Next; current != head; current = current->Next) {
+				if (MatchesColumnFilters(current->Item, filters)) {
+					matchingRows++;
+				}
+			}
+		}
 
+		messageHandler_.SendDatabaseRowCount(seq, databaseId, (uint32_t)facts.Size, matchingRows);
 		return ResultCode::Success;
 	}
 
@@ -149,9 +149,14 @@ namespace dse::osidbg
 		uint32_t maxBreakDepth_{ 0 };
 	};
 
+	using ColumnFilterList = google::protobuf::RepeatedPtrField<MsgColumnFilter>;
+
 	class Debugger
 	{
 	public:
+		// Number of rows sent in a single BkDatabaseRow message
+		static constexpr uint32_t DatabaseRowsPerMessage = 100;
+
 		Debugger(OsirisStaticGlobals & globals, DebugMessageHandler & messageHandler);
 		~Debugger();
 
@@ -175,7 +180,8 @@ namespace dse::osidbg
 		}
 
 		void FinishUpdatingNodeBreakpoints();
-		ResultCode GetDatabaseContents(uint32_t databaseId);
+		ResultCode GetDatabaseContents(uint32_t databaseId, uint32_t offset, uint32_t limit, ColumnFilterList const & filters);
+		ResultCode GetDatabaseRowCount(uint32_t seq, uint32_t databaseId, ColumnFilterList const & filters);
 		ResultCode ContinueExecution(DbgContinue_Action action, uint32_t breakpointMask, uint32_t flags);
 		void SyncStory();
 		void Evaluate(uint32_t seq, EvalType type, uint32_t nodeId, MsgTuple const & params, 
@@ -236,6 +242,8 @@ namespace dse::osidbg
 
 		void PushFrame(CallStackFrame const & frame);
 		void PopFrame(CallStackFrame const & frame);
+
+		ResultCode GetReadableDatabase(uint32_t databaseId, ColumnFilterList const & filters, Database *& db);
 	};
 }
 
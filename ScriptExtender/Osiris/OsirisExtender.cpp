@@ -2,6 +2,7 @@
 #include <Osiris/OsirisExtender.h>
 #include <Extender/Shared/ExtensionHelpers.h>
 #include <Extender/ScriptExtender.h>
+#include <Lua/Server/LuaOsiris.h>
 #include <iomanip>
 
 BEGIN_SE()
@@ -74,11 +75,24 @@ void OsirisExtender::OnBaseModuleLoaded()
 	customFunctions_.ClearDynamicEntries();
 }
 
+void OsirisExtender::OnUpdate()
+{
+#if !defined(OSI_NO_DEBUGGER)
+	// Send debugger messages that were buffered during the tick
+	if (debugMsgHandler_) {
+		debugMsgHandler_->Flush();
+	}
+#endif
+}
+
 void OsirisExtender::HookNodeVMTs()
 {
 	if (wrappers_.ResolveNodeVMTs()) {
+		// Database indexes must see every insert/delete, so they're kept attached when rehooking
+		auto databaseIndexes = nodeVmtWrappers_ ? nodeVmtWrappers_->DatabaseIndexAttachment : nullptr;
 		nodeVmtWrappers_.reset();
 		nodeVmtWrappers_ = std::make_unique<NodeVMTWrappers>(wrappers_.VMTs);
+		nodeVmtWrappers_->DatabaseIndexAttachment = databaseIndexes;
 	}
 }
 
@@ -204,6 +218,10 @@ void OsirisExtender::OnInitGame(void * Osiris)
 
 void OsirisExtender::OnDeleteAllData(void * Osiris, bool DeleteTypes)
 {
+	if (nodeVmtWrappers_ && nodeVmtWrappers_->DatabaseIndexAttachment) {
+		nodeVmtWrappers_->DatabaseIndexAttachment->ClearIndexes();
+	}
+
 #if !defined(OSI_NO_DEBUGGER)
 	if (debugger_) {
 		DEBUG("OsirisExtender::OnDeleteAllData()");
@@ -30,6 +30,7 @@ public:
 
 	void OnBaseModuleLoaded();
 	void HookNodeVMTs();
+	void OnUpdate();
 
 	void LogError(std::string_view msg);
 	void LogWarning(std::string_view msg);
@@ -3,6 +3,7 @@
 #include <stdafx.h>
 #include <Osiris/Shared/CustomFunctions.h>
 #include <Extender/ScriptExtender.h>
+#include <Version.h>
 #include <fstream>
 #include <sstream>
 
@@ -385,54 +386,117 @@ STDString CustomFunctionManager::GenerateHeaders() const
 	return STDString(ss.str());
 }
 
-void CustomFunctionManager::PreProcessStory(STDString const & original, STDString & postProcessed)
+namespace
 {
-	STDString ph1;
-	ph1.reserve(original.size());
+	constexpr std::string_view OsiToolsOnlyBegin = "/* [OSITOOLS_ONLY]";
+	constexpr std::string_view OsiToolsOnlyEnd = "*/";
+	constexpr std::string_view NoOsiToolsBegin = "// [BEGIN_NO_OSITOOLS]";
+	constexpr std::string_view NoOsiToolsEnd = "// [END_NO_OSITOOLS]";
+	constexpr std::string_view CompileTraceOption = "option compile_trace\r\n";
+}
+
+uint64_t CustomFunctionManager::HashStory(std::string_view contents)
+{
+	// FNV-1a style hash over 8-byte words; story files are several megabytes, hashing them bytewise is too slow
+	uint64_t hash = 0xcbf29ce484222325ull;
+	std::size_t i = 0;
+	for (; i + sizeof(uint64_t) <= contents.size(); i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, contents.data() + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+
+	for (; i < contents.size(); i++) {
+		hash = (hash ^ (uint8_t)contents[i]) * 0x100000001b3ull;
+	}
+
+	return hash ^ contents.size();
+}
+
+bool CustomFunctionManager::PreProcessStory(std::string_view original, STDString & postProcessed)
+{
+	constexpr auto npos = std::string_view::npos;
+
+	postProcessed.clear();
 	postProcessed.reserve(original.size());
 
+	// Both block types are processed in a single pass by always handling the marker closest to the read position.
+	// The end of an OSITOOLS_ONLY comment is tracked separately, as it may contain NO_OSITOOLS blocks.
+	auto onlyPos = original.find(OsiToolsOnlyBegin);
+	auto noPos = original.find(NoOsiToolsBegin);
+	auto commentEnd = npos;
 	std::size_t pos = 0;
-	while (pos < original.size()) {
-		auto next = original.find("/* [OSITOOLS_ONLY]", pos);
-		if (next == std::string::npos) {
-			ph1 += original.substr(pos);
-			break;
-		}
+	bool changed = false;
+
+	for (;;) {
+		// Markers overlapping text consumed by the previous one (eg. "*//" or a marker right after a tag) don't count
+		if (onlyPos < pos) onlyPos = original.find(OsiToolsOnlyBegin, pos);
+		if (noPos < pos) noPos = original.find(NoOsiToolsBegin, pos);
+
+		auto next = std::min({ onlyPos, noPos, commentEnd });
+		if (next == npos) break;
+
+		if (next == commentEnd) {
+			postProcessed.append(original.data() + pos, commentEnd - pos);
+			pos = commentEnd + OsiToolsOnlyEnd.size();
+			commentEnd = npos;
+		} else if (next == onlyPos) {
+			auto end = original.find(OsiToolsOnlyEnd, onlyPos);
+			if (end == npos) {
+				onlyPos = npos;
+				continue;
+			}
 
-		auto end = original.find("*/", next);
-		if (end == std::string::npos) {
-			ph1 += original.substr(pos);
-			break;
-		}
+			postProcessed.append(original.data() + pos, onlyPos - pos);
+			// Skip the newline after the tag as well
+			pos = std::min(onlyPos + OsiToolsOnlyBegin.size() + 1, end);
+			commentEnd = end;
+			onlyPos = original.find(OsiToolsOnlyBegin, end + OsiToolsOnlyEnd.size());
+			changed = true;
+		} else {
+			auto end = original.find(NoOsiToolsEnd, noPos);
+			if (end == npos) {
+				noPos = npos;
+				continue;
+			}
 
-		ph1 += original.substr(pos, next - pos);
-		ph1 += original.substr(next + 19, end - next - 19);
-		pos = end + 2;
-	}
+			postProcessed.append(original.data() + pos, noPos - pos);
+			pos = std::min(end + NoOsiToolsEnd.size() + 1, original.size());
 
-	pos = 0;
-	while (pos < ph1.size()) {
-		auto next = ph1.find("// [BEGIN_NO_OSITOOLS]", pos);
-		if (next == std::string::npos) {
-			postProcessed += ph1.substr(pos);
-			break;
-		}
+			// OSITOOLS_ONLY comments that start in the removed block may end after it
+			while (onlyPos < end) {
+				commentEnd = original.find(OsiToolsOnlyEnd, onlyPos);
+				onlyPos = (commentEnd == npos) ? npos : original.find(OsiToolsOnlyBegin, commentEnd + OsiToolsOnlyEnd.size());
+			}
 
-		auto end = ph1.find("// [END_NO_OSITOOLS]", next);
-		if (end == std::string::npos) {
-			postProcessed += ph1.substr(pos);
-			break;
+			if (commentEnd < pos) commentEnd = npos;
+			noPos = original.find(NoOsiToolsBegin, pos);
+			changed = true;
 		}
+	}
+
+	postProcessed.append(original.data() + pos, original.size() - pos);
+	return changed;
+}
 
-		postProcessed += ph1.substr(pos, next - pos);
-		pos = end + 21;
+CustomFunctionManager::PreprocessedStory const* CustomFunctionManager::FindPreprocessedStory(uint64_t hash, std::size_t size, bool preprocessorEnabled) const
+{
+	for (auto const& story : storyCache_) {
+		if (story.ContentHash == hash
+			&& story.ContentSize == size
+			&& story.ExtenderVersion == CurrentVersion
+			&& story.PreprocessorEnabled == preprocessorEnabled) {
+			return &story;
+		}
 	}
+
+	return nullptr;
 }
 
 void CustomFunctionManager::PreProcessStory(wchar_t const * path)
 {
 	STDString original;
-	STDString postProcessed;
 
 	{
 		std::ifstream f(path, std::ios::in | std::ios::binary);
@@ -444,29 +508,52 @@ void CustomFunctionManager::PreProcessStory(wchar_t const * path)
 		f.read(original.data(), original.size());
 	}
 
-	// Clear compile trace flags to avoid large compile traces
-	auto debugPos = original.find("option compile_trace\r\n");
-	if (debugPos != std::string::npos) {
-		for (std::size_t i = debugPos; i < debugPos + 20; i++) {
-			original[i] = ' ';
+	auto preprocessorEnabled = esv::ExtensionState::Get().HasFeatureFlag("Preprocessor");
+	auto hash = HashStory(original);
+	auto story = FindPreprocessedStory(hash, original.size(), preprocessorEnabled);
+
+	if (story == nullptr) {
+		if (storyCache_.size() >= MaxCachedStories) {
+			storyCache_.erase(storyCache_.begin());
 		}
-	}
 
-	if (esv::ExtensionState::Get().HasFeatureFlag("Preprocessor")) {
-		PreProcessStory(original, postProcessed);
-	} else {
-		postProcessed = original;
+		auto& entry = storyCache_.emplace_back();
+		entry.ContentHash = hash;
+		entry.ContentSize = original.size();
+		entry.ExtenderVersion = CurrentVersion;
+		entry.PreprocessorEnabled = preprocessorEnabled;
+		entry.Changed = false;
+
+		// Clear compile trace flags to avoid large compile traces
+		auto debugPos = original.find(CompileTraceOption);
+		if (debugPos != std::string::npos) {
+			std::fill_n(original.begin() + debugPos, CompileTraceOption.size() - 2, ' ');
+			entry.Changed = true;
+		}
+
+		if (preprocessorEnabled && PreProcessStory(original, entry.Contents)) {
+			entry.Changed = true;
+		} else if (entry.Changed) {
+			entry.Contents = std::move(original);
+		} else {
+			// Nothing to rewrite, don't keep a copy of the story around
+			entry.Contents = STDString();
+		}
+
+		story = &entry;
 	}
 
+	// Don't rewrite the story if the preprocessor had nothing to do
+	if (!story->Changed) return;
+
 	{
 		std::ofstream f(path, std::ios::out | std::ios::binary);
 		if (!f.good()) return;
 
-		f.write(postProcessed.data(), postProcessed.size());
+		f.write(story->Contents.data(), story->Contents.size());
 	}
 }
 
-
 CustomFunctionInjector::CustomFunctionInjector(OsirisWrappers & wrappers, CustomFunctionManager & functions)
 	: wrappers_(wrappers), functions_(functions)
 {}
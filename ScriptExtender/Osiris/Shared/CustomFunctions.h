@@ -252,9 +252,26 @@ namespace dse
 
 		STDString GenerateHeaders() const;
 		void PreProcessStory(wchar_t const * path);
-		void PreProcessStory(STDString const & original, STDString & postProcessed);
+		// Returns whether any preprocessor block was found in the story
+		static bool PreProcessStory(std::string_view original, STDString & postProcessed);
+		static uint64_t HashStory(std::string_view contents);
 
 	private:
+		// Number of preprocessed story files kept in memory between compilations
+		static constexpr std::size_t MaxCachedStories = 2;
+
+		struct PreprocessedStory
+		{
+			uint64_t ContentHash;
+			std::size_t ContentSize;
+			uint32_t ExtenderVersion;
+			bool PreprocessorEnabled;
+			// Whether the output differs from the original story file
+			bool Changed;
+			// Output of the preprocessor; only kept if the story was changed
+			STDString Contents;
+		};
+
 		struct DynamicFunctionBindingInfo
 		{
 			FunctionType Type; 
@@ -273,7 +290,9 @@ namespace dse
 		std::size_t numStaticQueries_{ 0 };
 		std::size_t numStaticEvents_{ 0 };
 		bool staticRegistrationDone_{ false };
+		std::vector<PreprocessedStory> storyCache_;
 
+		PreprocessedStory const* FindPreprocessedStory(uint64_t hash, std::size_t size, bool preprocessorEnabled) const;
 		void RegisterSignature(CustomFunction * func);
 		bool RegisterDynamicSignature(CustomFunction * func, uint32_t & index);
 	};
@@ -2,6 +2,7 @@
 #include <Osiris/Shared/NodeHooks.h>
 #include <Osiris/Debugger/Debugger.h>
 #include <Lua/Server/LuaOsiris.h>
+#include <GameHooks/Wrappers.h>
 #include <sstream>
 #include <memory>
 #include <cassert>
@@ -32,34 +33,34 @@ namespace dse
 
 	NodeVMTWrappers* gNodeVMTWrappers{ nullptr };
 
-	NodeVMTWrapper::NodeVMTWrapper(NodeVMT * vmt, NodeWrapOptions & options)
+	NodeVMTWrapper::NodeVMTWrapper(NodeVMT * vmt, NodeWrapOptions & options, NodeVMTTrampolines const & trampolines)
 		: vmt_(vmt), options_(options)
 	{
 		originalVmt_ = *vmt_;
 
 		ROWriteAnchor<NodeVMT> _(vmt_);
 		if (options_.WrapIsValid) {
-			vmt_->IsValid = &s_WrappedIsValid;
+			vmt_->IsValid = trampolines.IsValid;
 		}
 
 		if (options_.WrapPushDownTuple) {
-			vmt_->PushDownTuple = &s_WrappedPushDownTuple;
+			vmt_->PushDownTuple = trampolines.PushDownTuple;
 		}
 
 		if (options_.WrapPushDownTupleDelete) {
-			vmt_->PushDownTupleDelete = &s_WrappedPushDownTupleDelete;
+			vmt_->PushDownTupleDelete = trampolines.PushDownTupleDelete;
 		}
 
 		if (options_.WrapInsertTuple) {
-			vmt_->InsertTuple = &s_WrappedInsertTuple;
+			vmt_->InsertTuple = trampolines.InsertTuple;
 		}
 
 		if (options_.WrapDeleteTuple) {
-			vmt_->DeleteTuple = &s_WrappedDeleteTuple;
+			vmt_->DeleteTuple = trampolines.DeleteTuple;
 		}
 
 		if (options_.WrapCallQuery) {
-			vmt_->CallQuery = &s_WrappedCallQuery;
+			vmt_->CallQuery = trampolines.CallQuery;
 		}
 	}
 
@@ -99,35 +100,59 @@ namespace dse
 		return originalVmt_.CallQuery(node, args);
 	}
 
-	bool NodeVMTWrapper::s_WrappedIsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter)
+	// Entry points of a node type. Each node type gets its own set of functions,
+	// so the wrapper is known statically and the VMT of the node doesn't have to be looked up.
+	template <NodeType Type>
+	struct NodeTypeTrampolines
 	{
-		return gNodeVMTWrappers->WrappedIsValid(node, tuple, adapter);
-	}
+		static bool IsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter)
+		{
+			return gNodeVMTWrappers->WrappedIsValid(gNodeVMTWrappers->GetWrapper(Type), node, tuple, adapter);
+		}
 
-	void NodeVMTWrapper::s_WrappedPushDownTuple(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
-	{
-		gNodeVMTWrappers->WrappedPushDownTuple(node, tuple, adapter, which);
-	}
+		static void PushDownTuple(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
+		{
+			gNodeVMTWrappers->WrappedPushDownTuple(gNodeVMTWrappers->GetWrapper(Type), node, tuple, adapter, which);
+		}
 
-	void NodeVMTWrapper::s_WrappedPushDownTupleDelete(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
-	{
-		gNodeVMTWrappers->WrappedPushDownTupleDelete(node, tuple, adapter, which);
-	}
+		static void PushDownTupleDelete(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
+		{
+			gNodeVMTWrappers->WrappedPushDownTupleDelete(gNodeVMTWrappers->GetWrapper(Type), node, tuple, adapter, which);
+		}
 
-	void NodeVMTWrapper::s_WrappedInsertTuple(Node * node, TuplePtrLL * tuple)
-	{
-		gNodeVMTWrappers->WrappedInsertTuple(node, tuple);
-	}
+		static void InsertTuple(Node * node, TuplePtrLL * tuple)
+		{
+			gNodeVMTWrappers->WrappedInsertTuple(gNodeVMTWrappers->GetWrapper(Type), node, tuple);
+		}
 
-	void NodeVMTWrapper::s_WrappedDeleteTuple(Node * node, TuplePtrLL * tuple)
-	{
-		gNodeVMTWrappers->WrappedDeleteTuple(node, tuple);
-	}
+		static void DeleteTuple(Node * node, TuplePtrLL * tuple)
+		{
+			gNodeVMTWrappers->WrappedDeleteTuple(gNodeVMTWrappers->GetWrapper(Type), node, tuple);
+		}
 
-	bool NodeVMTWrapper::s_WrappedCallQuery(Node * node, OsiArgumentDesc * args)
-	{
-		return gNodeVMTWrappers->WrappedCallQuery(node, args);
-	}
+		static bool CallQuery(Node * node, OsiArgumentDesc * args)
+		{
+			return gNodeVMTWrappers->WrappedCallQuery(gNodeVMTWrappers->GetWrapper(Type), node, args);
+		}
+
+		static constexpr NodeVMTTrampolines Get()
+		{
+			return NodeVMTTrampolines{ &IsValid, &PushDownTuple, &PushDownTupleDelete, &InsertTuple, &DeleteTuple, &CallQuery };
+		}
+	};
+
+	NodeVMTTrampolines const NodeTrampolines[(unsigned)NodeType::Max + 1] = {
+		{}, // None
+		NodeTypeTrampolines<NodeType::Database>::Get(),
+		NodeTypeTrampolines<NodeType::Proc>::Get(),
+		NodeTypeTrampolines<NodeType::DivQuery>::Get(),
+		NodeTypeTrampolines<NodeType::And>::Get(),
+		NodeTypeTrampolines<NodeType::NotAnd>::Get(),
+		NodeTypeTrampolines<NodeType::RelOp>::Get(),
+		NodeTypeTrampolines<NodeType::Rule>::Get(),
+		NodeTypeTrampolines<NodeType::InternalQuery>::Get(),
+		NodeTypeTrampolines<NodeType::UserQuery>::Get()
+	};
 
 	NodeWrapOptions VMTWrapOptions[(unsigned)NodeType::Max + 1] = {
 		{ false, false, false, false, false, false }, // None
@@ -149,8 +174,16 @@ namespace dse
 		gNodeVMTWrappers = this;
 
 		for (unsigned i = 1; i < (unsigned)NodeType::Max + 1; i++) {
-			wrappers_[i] = std::make_unique<NodeVMTWrapper>(vmts_[i], VMTWrapOptions[i]);
-			vmtToTypeMap_[vmts[i]] = (NodeType)i;
+			wrappers_[i] = std::make_unique<NodeVMTWrapper>(vmts_[i], VMTWrapOptions[i], NodeTrampolines[i]);
+
+			// Wrapper frames appear in the stack trace of every crash during rule evaluation; don't report them
+			auto const& trampolines = NodeTrampolines[i];
+			gRegisteredTrampolines.insert((void*)trampolines.IsValid);
+			gRegisteredTrampolines.insert((void*)trampolines.PushDownTuple);
+			gRegisteredTrampolines.insert((void*)trampolines.PushDownTupleDelete);
+			gRegisteredTrampolines.insert((void*)trampolines.InsertTuple);
+			gRegisteredTrampolines.insert((void*)trampolines.DeleteTuple);
+			gRegisteredTrampolines.insert((void*)trampolines.CallQuery);
 		}
 	}
 
@@ -162,10 +195,16 @@ namespace dse
 
 	NodeType NodeVMTWrappers::GetType(Node * node)
 	{
+		// Only used outside of the hooked node calls (eg. by the debugger), where the type isn't known statically
 		NodeVMT * vfptr = *reinterpret_cast<NodeVMT **>(node);
-		auto typeIt = vmtToTypeMap_.find(vfptr);
-		if (typeIt == vmtToTypeMap_.end()) Fail("Called virtual method on a node that could not be identified");
-		return typeIt->second;
+		for (unsigned i = 1; i < (unsigned)NodeType::Max + 1; i++) {
+			if (vmts_[i] == vfptr) {
+				return (NodeType)i;
+			}
+		}
+
+		Fail("Called virtual method on a node that could not be identified");
+		return NodeType::None;
 	}
 
 	NodeVMTWrapper & NodeVMTWrappers::GetWrapper(Node * node)
@@ -175,10 +214,8 @@ namespace dse
 		return *wrappers_[(unsigned)type].get();
 	}
 
-	bool NodeVMTWrappers::WrappedIsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter)
+	bool NodeVMTWrappers::WrappedIsValid(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->IsValidPreHook(node, tuple, adapter);
 		}
@@ -192,10 +229,8 @@ namespace dse
 		return succeeded;
 	}
 
-	void NodeVMTWrappers::WrappedPushDownTuple(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
+	void NodeVMTWrappers::WrappedPushDownTuple(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, false);
 		}
@@ -207,10 +242,8 @@ namespace dse
 		}
 	}
 
-	void NodeVMTWrappers::WrappedPushDownTupleDelete(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
+	void NodeVMTWrappers::WrappedPushDownTupleDelete(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->PushDownPreHook(node, tuple, adapter, which, true);
 		}
@@ -222,10 +255,8 @@ namespace dse
 		}
 	}
 
-	void NodeVMTWrappers::WrappedInsertTuple(Node * node, TuplePtrLL * tuple)
+	void NodeVMTWrappers::WrappedInsertTuple(NodeVMTWrapper & wrapper, Node * node, TuplePtrLL * tuple)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->InsertPreHook(node, tuple, false);
 		}
@@ -234,8 +265,16 @@ namespace dse
 			OsirisCallbacksAttachment->InsertPreHook(node, tuple, false);
 		}
 
+		if (DatabaseIndexAttachment) {
+			DatabaseIndexAttachment->InsertPreHook(node, tuple, false);
+		}
+
 		wrapper.WrappedInsertTuple(node, tuple);
 
+		if (DatabaseIndexAttachment) {
+			DatabaseIndexAttachment->InsertPostHook(node, tuple, false);
+		}
+
 		if (DebuggerAttachment) {
 			DebuggerAttachment->InsertPostHook(node, tuple, false);
 		}
@@ -245,25 +284,29 @@ namespace dse
 		}
 	}
 
-	void NodeVMTWrappers::WrappedDeleteTuple(Node * node, TuplePtrLL * tuple)
+	void NodeVMTWrappers::WrappedDeleteTuple(NodeVMTWrapper & wrapper, Node * node, TuplePtrLL * tuple)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->InsertPreHook(node, tuple, true);
 		}
 
+		if (DatabaseIndexAttachment) {
+			DatabaseIndexAttachment->InsertPreHook(node, tuple, true);
+		}
+
 		wrapper.WrappedDeleteTuple(node, tuple);
 
+		if (DatabaseIndexAttachment) {
+			DatabaseIndexAttachment->InsertPostHook(node, tuple, true);
+		}
+
 		if (DebuggerAttachment) {
 			DebuggerAttachment->InsertPostHook(node, tuple, true);
 		}
 	}
 
-	bool NodeVMTWrappers::WrappedCallQuery(Node * node, OsiArgumentDesc * args)
+	bool NodeVMTWrappers::WrappedCallQuery(NodeVMTWrapper & wrapper, Node * node, OsiArgumentDesc * args)
 	{
-		auto & wrapper = GetWrapper(node);
-
 		if (DebuggerAttachment) {
 			DebuggerAttachment->CallQueryPreHook(node, args);
 		}
@@ -6,6 +6,7 @@
 
 BEGIN_NS(esv::lua)
 class OsirisCallbackManager;
+class OsirisDatabaseIndexManager;
 END_NS()
 
 BEGIN_NS(osidbg)
@@ -24,10 +25,21 @@ struct NodeWrapOptions
 	bool WrapCallQuery;
 };
 
+// Static entry points that are patched into the VMT of a node type
+struct NodeVMTTrampolines
+{
+	NodeVMT::IsValidProc IsValid;
+	NodeVMT::PushDownTupleProc PushDownTuple;
+	NodeVMT::PushDownTupleProc PushDownTupleDelete;
+	NodeVMT::InsertTupleProc InsertTuple;
+	NodeVMT::InsertTupleProc DeleteTuple;
+	NodeVMT::CallQueryProc CallQuery;
+};
+
 class NodeVMTWrapper
 {
 public:
-	NodeVMTWrapper(NodeVMT * vmt, NodeWrapOptions & options);
+	NodeVMTWrapper(NodeVMT * vmt, NodeWrapOptions & options, NodeVMTTrampolines const & trampolines);
 	~NodeVMTWrapper();
 
 	bool WrappedIsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter);
@@ -37,13 +49,6 @@ public:
 	void WrappedDeleteTuple(Node * node, TuplePtrLL * tuple);
 	bool WrappedCallQuery(Node * node, OsiArgumentDesc * args);
 
-	static bool s_WrappedIsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter);
-	static void s_WrappedPushDownTuple(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
-	static void s_WrappedPushDownTupleDelete(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
-	static void s_WrappedInsertTuple(Node * node, TuplePtrLL * tuple);
-	static void s_WrappedDeleteTuple(Node * node, TuplePtrLL * tuple);
-	static bool s_WrappedCallQuery(Node * node, OsiArgumentDesc * args);
-
 private:
 	NodeVMT * vmt_;
 	NodeWrapOptions & options_;
@@ -56,23 +61,28 @@ public:
 	NodeVMTWrappers(NodeVMT ** vmts);
 	~NodeVMTWrappers();
 
-	bool WrappedIsValid(Node * node, VirtTupleLL * tuple, AdapterRef * adapter);
-	void WrappedPushDownTuple(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
-	void WrappedPushDownTupleDelete(Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
-	void WrappedInsertTuple(Node * node, TuplePtrLL * tuple);
-	void WrappedDeleteTuple(Node * node, TuplePtrLL * tuple);
-	bool WrappedCallQuery(Node * node, OsiArgumentDesc * args);
+	bool WrappedIsValid(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter);
+	void WrappedPushDownTuple(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
+	void WrappedPushDownTupleDelete(NodeVMTWrapper & wrapper, Node * node, VirtTupleLL * tuple, AdapterRef * adapter, EntryPoint which);
+	void WrappedInsertTuple(NodeVMTWrapper & wrapper, Node * node, TuplePtrLL * tuple);
+	void WrappedDeleteTuple(NodeVMTWrapper & wrapper, Node * node, TuplePtrLL * tuple);
+	bool WrappedCallQuery(NodeVMTWrapper & wrapper, Node * node, OsiArgumentDesc * args);
 
 	osidbg::Debugger* DebuggerAttachment{ nullptr };
 	esv::lua::OsirisCallbackManager* OsirisCallbacksAttachment{ nullptr };
+	esv::lua::OsirisDatabaseIndexManager* DatabaseIndexAttachment{ nullptr };
 
 	NodeType GetType(Node * node);
 	NodeVMTWrapper & GetWrapper(Node * node);
 
+	inline NodeVMTWrapper & GetWrapper(NodeType type)
+	{
+		return *wrappers_[(unsigned)type];
+	}
+
 private:
 	NodeVMT ** vmts_;
 	std::unique_ptr<NodeVMTWrapper> wrappers_[(unsigned)NodeType::Max + 1];
-	std::unordered_map<NodeVMT *, NodeType> vmtToTypeMap_;
 };
 
 END_SE()
@@ -34,7 +34,7 @@ namespace dse
 	}
 }
 
-std::optional<std::string> GetExeResource(int resourceId)
+std::optional<std::string_view> GetExeResourceView(int resourceId)
 {
 	auto hResource = FindResource(gThisModule, MAKEINTRESOURCE(resourceId), L"SCRIPT_EXTENDER");
 
@@ -44,10 +44,7 @@ std::optional<std::string> GetExeResource(int resourceId)
 			auto resourceData = LockResource(hGlobal);
 			if (resourceData) {
 				DWORD resourceSize = SizeofResource(gThisModule, hResource);
-				std::string contents;
-				contents.resize(resourceSize);
-				memcpy(contents.data(), resourceData, resourceSize);
-				return contents;
+				return std::string_view(reinterpret_cast<char const*>(resourceData), resourceSize);
 			}
 		}
 	}
@@ -56,6 +53,16 @@ std::optional<std::string> GetExeResource(int resourceId)
 	return {};
 }
 
+std::optional<std::string> GetExeResource(int resourceId)
+{
+	auto resource = GetExeResourceView(resourceId);
+	if (resource) {
+		return std::string(*resource);
+	} else {
+		return {};
+	}
+}
+
 
 std::string ToUTF8(std::wstring_view s)
 {
@@ -103,6 +103,8 @@ void LogOsirisWarning(std::string_view msg);
 void LogOsirisMsg(std::string_view msg);
 
 std::optional<std::string> GetExeResource(int resourceId);
+// Returns a view of the resource data; resources remain mapped for the lifetime of the module
+std::optional<std::string_view> GetExeResourceView(int resourceId);
 
 BEGIN_SE()
 
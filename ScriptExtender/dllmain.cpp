@@ -65,6 +65,7 @@ void LoadConfig(std::wstring const & configPath, dse::ExtenderConfig & config)
 	ConfigGet(root, "EnableDebugger", config.EnableDebugger);
 	ConfigGet(root, "EnableLuaDebugger", config.EnableLuaDebugger);
 	ConfigGet(root, "OptimizeHashing", config.OptimizeHashing);
+	ConfigGet(root, "EnableSymbolCache", config.EnableSymbolCache);
 	ConfigGet(root, "DisableModValidation", config.DisableModValidation);
 	ConfigGet(root, "DeveloperMode", config.DeveloperMode);
 	ConfigGet(root, "ShowPerfWarnings", config.ShowPerfWarnings);
@@ -74,6 +75,8 @@ void LoadConfig(std::wstring const & configPath, dse::ExtenderConfig & config)
 	ConfigGet(root, "DebuggerPort", config.DebuggerPort);
 	ConfigGet(root, "LuaDebuggerPort", config.LuaDebuggerPort);
 	ConfigGet(root, "DebugFlags", config.DebugFlags);
+	ConfigGet(root, "LuaGCBudget", config.LuaGCBudget);
+	ConfigGet(root, "LuaGCFullCollectOnLoad", config.LuaGCFullCollectOnLoad);
 
 	ConfigGet(root, "LogDirectory", config.LogDirectory);
 	ConfigGet(root, "LuaBuiltinResourceDirectory", config.LuaBuiltinResourceDirectory);
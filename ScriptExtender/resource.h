@@ -8,6 +8,7 @@
 #define IDR_LUA_BUILTIN_BUNDLE          101
 #define IDR_BINARY_MAPPINGS_EOCAPP      107
 #define IDR_BINARY_MAPPINGS_EOCPLUGIN   108
+#define IDR_BINARY_MAPPINGS_COMPILED    111
 
 #if defined(USE_GAME_SYMBOL_TABLE)
 #define IDR_SYMBOL_TABLE_GAME           109
@@ -21,9 +22,9 @@
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
-#define _APS_NEXT_RESOURCE_VALUE        111
+#define _APS_NEXT_RESOURCE_VALUE        112
 #define _APS_NEXT_COMMAND_VALUE         40001
 #define _APS_NEXT_CONTROL_VALUE         1001
-#define _APS_NEXT_SYMED_VALUE           111
+#define _APS_NEXT_SYMED_VALUE           112
 #endif
 #endif